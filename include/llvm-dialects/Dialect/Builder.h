@@ -37,6 +37,14 @@ public:
   Builder(llvm::BasicBlock *block, llvm::BasicBlock::iterator it)
       : IRBuilder(block, it), m_dialects(DialectContext::get(getContext())) {}
 
+  /// Create a builder without looking up the DialectContext of the
+  /// LLVMContext. Operations created through the builder obtain their dialect
+  /// from the builder, so no global or thread-local state is touched.
+  explicit Builder(DialectContext& dialects)
+      : IRBuilder(dialects.getContext()), m_dialects(dialects) {}
+
+  DialectContext& getDialectContext() const {return m_dialects;}
+
   template <typename DialectT>
   DialectT& getDialect() const {return m_dialects.getDialect<DialectT>();}
 
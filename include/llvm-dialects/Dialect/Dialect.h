@@ -17,6 +17,7 @@
 #pragma once
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/TrailingObjects.h"
 
@@ -24,12 +25,21 @@ namespace llvm {
 class CallInst;
 class Function;
 class LLVMContext;
+class Module;
+class Type;
+class Value;
 } // namespace llvm
 
 namespace llvm_dialects {
 
 class Dialect;
 class DialectContext;
+class OpDescription;
+
+namespace detail {
+class DeclarationDirectory;
+class OverloadCache;
+} // namespace detail
 
 struct DialectDescriptor {
   unsigned index;
@@ -83,6 +93,9 @@ class DialectContext final : private llvm::TrailingObjects<DialectContext, Diale
 
   llvm::LLVMContext& m_llvmContext;
   unsigned m_dialectArraySize;
+  std::unique_ptr<detail::OverloadCache> m_overloadCache;
+  std::unique_ptr<detail::DeclarationDirectory> m_declarationDirectory;
+  bool m_compactOverloadNames = false;
 
   DialectContext(llvm::LLVMContext& context, unsigned dialectArraySize);
 
@@ -129,6 +142,88 @@ public:
   bool hasDialect() const {
     return getTrailingObjects<Dialect*>()[DialectT::getIndex()];
   }
+
+  /// Use compact names for the declarations of overloaded operations, see
+  /// @ref getCompactMangledName. This shrinks the symbol and string tables of
+  /// modules with many overloads. Operations are recognized by their name
+  /// prefix, so modules can contain both forms.
+  void setCompactOverloadNames(bool compact) {
+    m_compactOverloadNames = compact;
+  }
+  bool hasCompactOverloadNames() const { return m_compactOverloadNames; }
+
+  /// Return the declaration name of an overload of the operation
+  /// @p mnemonic, in the form selected by @ref setCompactOverloadNames.
+  std::string getOverloadName(llvm::StringRef mnemonic,
+                              llvm::ArrayRef<llvm::Type *> overloadTypes) const;
+
+  /// Return the declaration name of an overload of the operation
+  /// @p mnemonic that returns @p resultType in @p module. If the compact name
+  /// is already taken by a function with a different result type, i.e. the
+  /// hashes of two overloads collide, the full mangled name is used instead.
+  std::string getOverloadName(llvm::Module &module, llvm::StringRef mnemonic,
+                              llvm::Type *resultType,
+                              llvm::ArrayRef<llvm::Type *> overloadTypes) const;
+
+  /// Get or insert the declaration of a different overload of the operation
+  /// declared by @p decl, in the same module.
+  ///
+  /// The new declaration is named by mangling @p overloadTypes onto
+  /// @p mnemonic, see @ref getOverloadName. It returns @p resultType and otherwise has the same
+  /// parameters and attributes as @p decl. Lookups are cached per naming
+  /// mode, so that the mangled name only needs to be built once per overload.
+  llvm::Function *getOrInsertOverload(llvm::Function *decl,
+                                      llvm::StringRef mnemonic,
+                                      llvm::Type *resultType,
+                                      llvm::ArrayRef<llvm::Type *> overloadTypes);
+
+  /// Enable or disable the declaration directory.
+  ///
+  /// The directory lists the function declarations of each module grouped by
+  /// the dialect prefix of their name (e.g. "xd" or "llvm") and, on demand, by
+  /// operation. Visitors and other queries then only look at the relevant
+  /// group instead of all functions of the module.
+  ///
+  /// A module's entry is built on first use and updated by the generated
+  /// builders via @ref noteDeclaration. Deleted declarations drop out of the
+  /// entry automatically. The entry is rebuilt lazily when functions are
+  /// appended to the module in other ways, e.g. by getOrInsertFunction or by
+  /// loading bitcode, and when the module is replaced by a new one at the same
+  /// address.
+  ///
+  /// Use @ref invalidateDeclarationDirectory when declarations are renamed, or
+  /// inserted in the middle of the module's function list while other symbols
+  /// are deleted. Invalidating the entry of a module that is about to be
+  /// destroyed frees it early; otherwise, it is pruned eventually.
+  ///
+  /// The directory is only used by queries that are given the DialectContext
+  /// explicitly, such as @ref forEachDeclaration.
+  void enableDeclarationDirectory(bool enable = true);
+  bool isDeclarationDirectoryEnabled() const {
+    return m_declarationDirectory != nullptr;
+  }
+
+  /// Forget the directory entry of @p module.
+  void invalidateDeclarationDirectory(llvm::Module &module);
+
+  /// Hook for the generated builders: record @p callee, as returned by
+  /// getOrInsertFunction, in the declaration directory.
+  void noteDeclaration(llvm::Value *callee) {
+    if (m_declarationDirectory)
+      noteDeclarationImpl(callee);
+  }
+
+  /// Call @p callback for every declaration in @p module that matches
+  /// @p desc. The callback may add declarations, which are not visited, but
+  /// must not remove any.
+  ///
+  /// Uses the declaration directory if it is enabled, and otherwise scans all
+  /// functions of the module.
+  void forEachDeclaration(llvm::Module &module, const OpDescription &desc,
+                          llvm::function_ref<void(llvm::Function &)> callback);
+
+private:
+  void noteDeclarationImpl(llvm::Value *callee);
 };
 
 /// CRTP helper for the TableGen-generated dialect classes.
@@ -163,6 +258,7 @@ bool isOverloadedOperationDecl(const llvm::Function *fn, llvm::StringRef name);
 
 bool isSimpleOperation(const llvm::CallInst *i, llvm::StringRef name);
 bool isOverloadedOperation(const llvm::CallInst *i, llvm::StringRef name);
+bool isIntrinsicOperation(const llvm::CallInst *i, unsigned intrinsicId);
 
 } // namespae detail
 
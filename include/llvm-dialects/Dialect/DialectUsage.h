@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2023 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "llvm-dialects/Dialect/OpDescription.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/PassManager.h"
+
+#include <string>
+#include <utility>
+
+namespace llvm {
+class Function;
+class Module;
+} // namespace llvm
+
+namespace llvm_dialects {
+
+/// @brief The set of op families that are tracked by dialect usage summaries
+///
+/// A family is either a whole dialect or an explicit list of operations. Each
+/// family is identified by the index returned when it is added.
+///
+/// Summaries are stored together with a hash of the schema, so that a summary
+/// computed with a different schema (e.g. by a different version of the
+/// compiler, before the module was written to bitcode) is never misread.
+///
+/// Example use:
+///
+/// @code
+///   DialectUsageSchema schema;
+///   unsigned xdFamily = schema.addDialect<xd::ExampleDialect>();
+///   unsigned memFamily = schema.addOps<xd::ReadOp, xd::WriteOp>();
+///   ...
+///   computeDialectUsage(module, schema);
+///   ...
+///   for (Function &fn : module) {
+///     if (!mayUseDialectFamily(fn, schema, memFamily))
+///       continue;
+///     ...
+///   }
+/// @endcode
+class DialectUsageSchema {
+public:
+  /// Add a family that contains all operations of the dialect with the given
+  /// name.
+  ///
+  /// Intrinsic-backed operations (see the generated `getIntrinsicOps`) are only
+  /// part of the family if given as @p intrinsicOps. The templated overload
+  /// passes them automatically.
+  unsigned addDialect(llvm::StringRef name,
+                      llvm::ArrayRef<const OpDescription *> intrinsicOps = {});
+
+  template <typename DialectT> unsigned addDialect() {
+    return addDialect(DialectT::getName(), DialectT::getIntrinsicOps());
+  }
+
+  /// Add a family that contains the given operations.
+  unsigned addOps(llvm::ArrayRef<const OpDescription *> ops);
+
+  template <typename... OpTs> unsigned addOps() {
+    const OpDescription *ops[] = {&OpDescription::get<OpTs>()...};
+    return addOps(ops);
+  }
+
+  unsigned size() const { return m_families.size(); }
+  uint64_t getHash() const { return m_hash; }
+
+  /// Set the bits of all families that the given declaration belongs to.
+  void matchDeclaration(llvm::Function &decl, llvm::BitVector &families) const;
+
+private:
+  void addToHash(llvm::StringRef str);
+
+  struct Family {
+    std::string dialectPrefix; // empty for explicit op lists
+    llvm::SmallVector<const OpDescription *> ops; // in addition to the prefix
+  };
+
+  std::vector<Family> m_families;
+  uint64_t m_hash = 0;
+};
+
+/// Compute the dialect usage summaries of all function definitions in the
+/// module and store them as function metadata.
+void computeDialectUsage(llvm::Module &module, const DialectUsageSchema &schema);
+
+/// Compute the dialect usage summaries only of those function definitions
+/// that do not currently have a summary for the given schema.
+void refreshDialectUsage(llvm::Module &module, const DialectUsageSchema &schema);
+
+/// Read the dialect usage summary of a function. Returns false if the function
+/// has no summary for the given schema.
+bool getDialectUsage(const llvm::Function &fn, const DialectUsageSchema &schema,
+                     llvm::BitVector &families);
+
+/// Record that the function uses the given family. Passes that create
+/// dialect operations should call this to keep summaries up-to-date.
+///
+/// Does nothing if the function has no summary for the given schema.
+void addDialectUsage(llvm::Function &fn, const DialectUsageSchema &schema,
+                     unsigned family);
+
+/// Remove the dialect usage summary from a function. The summary is
+/// recomputed by the next @ref refreshDialectUsage.
+void invalidateDialectUsage(llvm::Function &fn);
+
+/// Check whether the function may use an operation of the given family.
+///
+/// This is conservatively true if the function has no summary for the given
+/// schema.
+bool mayUseDialectFamily(const llvm::Function &fn,
+                         const DialectUsageSchema &schema, unsigned family);
+
+/// New pass manager pass that computes missing dialect usage summaries, see
+/// @ref refreshDialectUsage.
+class DialectUsagePass : public llvm::PassInfoMixin<DialectUsagePass> {
+public:
+  explicit DialectUsagePass(DialectUsageSchema schema)
+      : m_schema(std::move(schema)) {}
+
+  llvm::PreservedAnalyses run(llvm::Module &module,
+                              llvm::ModuleAnalysisManager &analysisManager);
+
+  static llvm::StringRef name() { return "llvm-dialects-usage"; }
+
+private:
+  DialectUsageSchema m_schema;
+};
+
+} // namespace llvm_dialects
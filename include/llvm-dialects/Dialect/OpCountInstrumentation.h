@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+class Module;
+} // namespace llvm
+
+namespace llvm_dialects {
+
+class OpDescription;
+
+/// Insert counters that record how often each of the given dialect operations
+/// is executed at run time.
+///
+/// Every call to one of the @p ops (including all overloads of overloaded
+/// operations) is preceded by an atomic increment of the corresponding entry
+/// in the module-level counter array `@llvm_dialects.op_counts`. The counters
+/// are indexed in the order in which @p ops are given.
+///
+/// In addition, an internal function `void @llvm_dialects.dump_op_counts()` is
+/// defined that prints one "<mnemonic>: <count>" line per operation via
+/// `printf`. If @p dumpAtExit is set, this function is also registered as a
+/// global destructor, so that the counts are printed when e.g. running the
+/// instrumented (and lowered) module under `lli`.
+///
+/// This must run before the instrumented operations are lowered. A module can
+/// only be instrumented once: if it already contains the counters, it is left
+/// unchanged. Returns true if the module was instrumented.
+bool instrumentOpCounts(llvm::Module &module,
+                        llvm::ArrayRef<const OpDescription *> ops,
+                        bool dumpAtExit = true);
+
+/// New pass manager wrapper around @ref instrumentOpCounts.
+class OpCountInstrumentationPass
+    : public llvm::PassInfoMixin<OpCountInstrumentationPass> {
+public:
+  explicit OpCountInstrumentationPass(llvm::ArrayRef<const OpDescription *> ops,
+                                      bool dumpAtExit = true)
+      : m_ops(ops.begin(), ops.end()), m_dumpAtExit(dumpAtExit) {}
+
+  llvm::PreservedAnalyses run(llvm::Module &module,
+                              llvm::ModuleAnalysisManager &analysisManager);
+
+  static llvm::StringRef name() { return "llvm-dialects-op-counts"; }
+
+private:
+  llvm::SmallVector<const OpDescription *> m_ops;
+  bool m_dumpAtExit;
+};
+
+} // namespace llvm_dialects
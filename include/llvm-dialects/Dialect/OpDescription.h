@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 
 namespace llvm {
@@ -28,18 +29,44 @@ namespace llvm_dialects {
 /// @brief Reflect an operation defined by a dialect
 class OpDescription {
 public:
-  OpDescription(bool hasOverloads, llvm::StringRef mnemonic)
-      : m_hasOverloads(hasOverloads), m_mnemonic(mnemonic) {}
+  OpDescription(bool hasOverloads, llvm::StringRef mnemonic,
+                llvm::ArrayRef<unsigned> attributeOperands = {})
+      : m_hasOverloads(hasOverloads), m_mnemonic(mnemonic),
+        m_attributeOperands(attributeOperands) {}
+
+  /// Describe an operation that is represented as a call of the LLVM intrinsic
+  /// with the given ID.
+  OpDescription(llvm::StringRef mnemonic, unsigned intrinsicId,
+                llvm::ArrayRef<unsigned> attributeOperands = {})
+      : m_hasOverloads(false), m_mnemonic(mnemonic),
+        m_attributeOperands(attributeOperands), m_intrinsicId(intrinsicId) {}
 
   template <typename OpT>
   static const OpDescription& get();
 
+  bool hasOverloads() const { return m_hasOverloads; }
+  llvm::StringRef getMnemonic() const { return m_mnemonic; }
+  bool isIntrinsic() const { return m_intrinsicId != 0; }
+  unsigned getIntrinsicId() const { return m_intrinsicId; }
+
+  /// The indices of the call arguments that hold attributes. The referenced
+  /// array must outlive the description.
+  llvm::ArrayRef<unsigned> getAttributeOperands() const {
+    return m_attributeOperands;
+  }
+  bool isAttributeOperand(unsigned argIdx) const;
+
   bool matchInstruction(llvm::Instruction &inst) const;
   bool matchDeclaration(llvm::Function &decl) const;
 
 private:
   bool m_hasOverloads;
   llvm::StringRef m_mnemonic;
+  llvm::ArrayRef<unsigned> m_attributeOperands;
+
+  /// The llvm::Intrinsic::ID of intrinsic-backed operations, or 0
+  /// (Intrinsic::not_intrinsic).
+  unsigned m_intrinsicId = 0;
 };
 
 } // namespace llvm_dialects
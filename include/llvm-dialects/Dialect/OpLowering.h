@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "llvm-dialects/Dialect/OpDescription.h"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/Instructions.h"
+
+#include <functional>
+
+namespace llvm {
+class Module;
+class Value;
+} // namespace llvm
+
+namespace llvm_dialects {
+
+class Builder;
+
+enum class LoweringMode {
+  /// Expand the lowering at every call site.
+  Inline,
+
+  /// Emit the lowering once per module for each distinct instantiation of an
+  /// operation into an internal helper function, and replace the operations
+  /// by calls of the helpers.
+  Outline,
+};
+
+/// @brief Lower dialect operations using per-operation callbacks
+///
+/// A lowering callback is invoked with the builder positioned before the
+/// operation. It must return the value that replaces the operation's result,
+/// or nullptr if the result is unused (e.g. because it is void). The operation
+/// itself is erased afterwards. Callbacks may split the containing block.
+///
+/// In @ref LoweringMode::Outline, the callback is instead invoked on a copy of
+/// the operation in the body of a helper function. The helpers are keyed by
+/// the operation, its overload types and the values of its attribute operands
+/// (see @ref OpDescription::getAttributeOperands). Attributes remain constant
+/// in the helper, so that their getters keep working, while all other operands
+/// become parameters of the helper, even if they happen to be constant.
+/// Compile time and code size then scale with the number of distinct
+/// instantiations instead of the number of call sites.
+///
+/// Helpers are named "llvm_dialects.lowered.<declaration name>", have internal
+/// linkage and carry the string function attribute "llvm_dialects.lowered"
+/// with the name of the lowered declaration, so that later inlining decisions
+/// can find them.
+///
+/// Example use:
+///
+/// @code
+///   OpLowering lowering{LoweringMode::Outline};
+///   lowering.add<xd::CombineOp>([](Builder &b, xd::CombineOp &op) {
+///     return b.CreateXor(op.getLhs(), op.getRhs());
+///   });
+///   lowering.run(module);
+/// @endcode
+class OpLowering {
+public:
+  template <typename OpT>
+  using Callback = std::function<llvm::Value *(Builder &, OpT &)>;
+
+  explicit OpLowering(LoweringMode mode) : m_mode(mode) {}
+
+  template <typename OpT> OpLowering &add(Callback<OpT> callback) {
+    add(OpDescription::get<OpT>(),
+        [callback = std::move(callback)](Builder &b, llvm::CallInst &op) {
+          return callback(b, llvm::cast<OpT>(op));
+        });
+    // The description of an intrinsic-backed operation only checks the
+    // intrinsic, not the types that the operation fixes.
+    m_entries.back().match = [](const llvm::CallInst &op) {
+      return llvm::isa<OpT>(op);
+    };
+    return *this;
+  }
+
+  OpLowering &add(const OpDescription &desc,
+                  Callback<llvm::CallInst> callback);
+
+  /// Lower all operations for which a callback was added. Returns the number
+  /// of lowered operations.
+  unsigned run(llvm::Module &module) const;
+
+private:
+  struct Entry {
+    const OpDescription *desc;
+    Callback<llvm::CallInst> callback;
+    bool (*match)(const llvm::CallInst &) = nullptr;
+  };
+
+  LoweringMode m_mode;
+  llvm::SmallVector<Entry> m_entries;
+};
+
+} // namespace llvm_dialects
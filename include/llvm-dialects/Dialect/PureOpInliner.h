@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2023 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/PassManager.h"
+
+#include <string>
+
+namespace llvm {
+class Function;
+class Module;
+} // namespace llvm
+
+namespace llvm_dialects {
+
+/// Check whether @p fn is trivially inlinable: a single-block function
+/// definition whose body consists of at most @p maxOps calls to pure operations
+/// of the given @p dialects, followed by a return.
+///
+/// An operation is considered pure if its declaration does not access memory,
+/// will return and does not unwind. These are exactly the attributes that the
+/// generated code derives from the `Memory<[]>`, `WillReturn` and `NoUnwind`
+/// traits, so no dialect-specific knowledge is required here.
+///
+/// Intrinsic-backed operations (see the generated `getIntrinsicOps`) never
+/// count as operations of @p dialects, since LLVM's inliner already
+/// understands their cost. A function that calls one is not trivially
+/// inlinable.
+bool isTriviallyInlinable(const llvm::Function &fn,
+                          llvm::ArrayRef<llvm::StringRef> dialects,
+                          unsigned maxOps = 8);
+
+/// Inline all direct calls of trivially inlinable functions, see
+/// @ref isTriviallyInlinable. Inlined functions that become unused and can be
+/// discarded are removed from the module.
+///
+/// LLVM's inliner treats dialect operations as opaque calls of unknown cost, so
+/// running this before the regular inliner exposes the operations to the
+/// caller's optimizations. Functions marked `noinline` or `optnone`, functions
+/// that may be replaced at link time, and call sites marked `noinline` are left
+/// alone.
+///
+/// Returns true if the module was changed.
+bool inlinePureDialectFunctions(llvm::Module &module,
+                                llvm::ArrayRef<llvm::StringRef> dialects,
+                                unsigned maxOps = 8);
+
+/// New pass manager wrapper around @ref inlinePureDialectFunctions.
+class PureOpInlinerPass : public llvm::PassInfoMixin<PureOpInlinerPass> {
+public:
+  explicit PureOpInlinerPass(llvm::ArrayRef<llvm::StringRef> dialects,
+                             unsigned maxOps = 8)
+      : m_maxOps(maxOps) {
+    for (llvm::StringRef dialect : dialects)
+      m_dialects.push_back(dialect.str());
+  }
+
+  llvm::PreservedAnalyses run(llvm::Module &module,
+                              llvm::ModuleAnalysisManager &analysisManager);
+
+  static llvm::StringRef name() { return "llvm-dialects-pure-op-inliner"; }
+
+private:
+  llvm::SmallVector<std::string> m_dialects;
+  unsigned m_maxOps;
+};
+
+} // namespace llvm_dialects
@@ -19,11 +19,16 @@
 #include "llvm/ADT/ArrayRef.h"
 
 namespace llvm {
+class CallInst;
 class Type;
+class Value;
 } // namespace llvm
 
 namespace llvm_dialects {
 
+class Builder;
+class OpDescription;
+
 /// Returns true if the given types are all equal. See the SameTypes predicate
 /// in TableGen.
 bool areTypesEqual(llvm::ArrayRef<llvm::Type *> types);
@@ -31,4 +36,34 @@ bool areTypesEqual(llvm::ArrayRef<llvm::Type *> types);
 std::string getMangledName(llvm::StringRef name,
                            llvm::ArrayRef<llvm::Type *> overloadTypes);
 
+/// Return a compact variant of @ref getMangledName: @p name followed by "._"
+/// and a 48-bit hash of the mangled overload types, e.g.
+/// "xd.combine._5c2f7e0a91b3". The full name is returned instead if it is not
+/// longer. The hash is stable across hosts and runs, so that declarations of
+/// the same overload in different modules still have the same name.
+///
+/// The overload types are not encoded in the name. In generated code, they
+/// are the result types, which can be recovered from the declaration's type.
+std::string getCompactMangledName(llvm::StringRef name,
+                                  llvm::ArrayRef<llvm::Type *> overloadTypes);
+
+/// Clone the overloaded dialect operation @p op, described by @p desc, as a
+/// call to the overload given by @p overloadTypes and returning @p resultType.
+///
+/// The operand list, call attributes, metadata and debug location are copied
+/// from @p op as-is, and the new call is inserted at the builder's insertion
+/// point. The caller is responsible for updating operands whose types are
+/// tied to the overload types. Verifier rules are not checked again.
+llvm::CallInst *cloneDialectOp(Builder &builder, llvm::CallInst &op,
+                               const OpDescription &desc,
+                               llvm::Type *resultType,
+                               llvm::ArrayRef<llvm::Type *> overloadTypes);
+
+/// Create a call of the LLVM intrinsic @p intrinsicId that returns
+/// @p resultType, at the builder's insertion point. The intrinsic's overload
+/// types are deduced from @p resultType and the types of @p args.
+llvm::CallInst *createIntrinsicCall(Builder &builder, unsigned intrinsicId,
+                                    llvm::Type *resultType,
+                                    llvm::ArrayRef<llvm::Value *> args);
+
 } // namespace llvm_dialects
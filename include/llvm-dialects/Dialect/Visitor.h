@@ -29,6 +29,8 @@ class Module;
 
 namespace llvm_dialects {
 
+class DialectContext;
+
 template <typename PayloadT>
 class Visitor;
 
@@ -40,6 +42,11 @@ enum class VisitorStrategy {
   /// Iterate over the function declarations in a module, filter out those for
   /// relevant dialect ops, and then iterate over their users.
   ///
+  /// If a DialectContext is passed to @ref Visitor::visit and its declaration
+  /// directory is enabled, only the declarations of the relevant ops are
+  /// looked at. Operations are then visited case by case instead of
+  /// declaration by declaration.
+  ///
   /// If a visitor is ever used to also visit core LLVM operations, we fall
   /// back to @ref ByInstruction.
   ByFunctionDeclaration,
@@ -69,8 +76,10 @@ class VisitorBase {
 protected:
   VisitorBase(VisitorBuilderBase builder);
 
-  void visit(void *payload, llvm::Function &fn) const;
-  void visit(void *payload, llvm::Module &module) const;
+  void visit(void *payload, llvm::Function &fn,
+             DialectContext *dialectContext = nullptr) const;
+  void visit(void *payload, llvm::Module &module,
+             DialectContext *dialectContext = nullptr) const;
 
 private:
   VisitorStrategy m_strategy;
@@ -100,6 +109,17 @@ public:
   void visit(PayloadT &payload, llvm::Module &module) const {
     VisitorBase::visit(static_cast<void *>(&payload), module);
   }
+
+  /// Visit using the declaration directory of @p dialectContext, if enabled.
+  void visit(PayloadT &payload, llvm::Function &fn,
+             DialectContext &dialectContext) const {
+    VisitorBase::visit(static_cast<void *>(&payload), fn, &dialectContext);
+  }
+
+  void visit(PayloadT &payload, llvm::Module &module,
+             DialectContext &dialectContext) const {
+    VisitorBase::visit(static_cast<void *>(&payload), module, &dialectContext);
+  }
 };
 
 /// @brief Build a visitor for dialect operations
@@ -142,8 +162,12 @@ public:
         OpDescription::get<OpT>(),
         (void *)fn,
         [](void *extra, void *payload, llvm::Instruction *op) {
-          auto fn = (void (*)(PayloadT &, OpT &))extra;
-          fn(*static_cast<PayloadT *>(payload), *llvm::cast<OpT>(op));
+          // The description of an intrinsic-backed operation only checks the
+          // intrinsic, not the types that the operation fixes.
+          if (auto *typedOp = llvm::dyn_cast<OpT>(op)) {
+            auto fn = (void (*)(PayloadT &, OpT &))extra;
+            fn(*static_cast<PayloadT *>(payload), *typedOp);
+          }
         });
     return *this;
   }
@@ -39,6 +39,7 @@ public:
     Type_Last = DialectType,
 
     Attr,
+    Variadic,
     BaseCPred_First,
     BaseCPred = BaseCPred_First,
     SameTypes,
@@ -164,6 +165,31 @@ private:
   std::string m_fromLlvmValue;
 };
 
+/// A variable number of trailing operation arguments, each of which satisfies
+/// the element constraint.
+class Variadic : public Constraint {
+public:
+  Variadic() : Constraint(Kind::Variadic) {}
+
+  void init(GenDialectsContext *context, llvm::Record *record) override;
+
+  std::pair<unsigned, unsigned> getMinMaxArgs() const final { return {1, 1}; }
+
+  std::string apply(FmtContext *fmt,
+                    llvm::ArrayRef<llvm::StringRef> arguments) const final {
+    llvm_unreachable("cannot apply a Variadic predicate");
+  }
+
+  Constraint *getElementType() const { return m_elementType; }
+
+  static bool classof(const Constraint *c) {
+    return c->getKind() == Kind::Variadic;
+  }
+
+private:
+  Constraint *m_elementType = nullptr;
+};
+
 class BaseCPred : public Constraint {
 public:
   BaseCPred(llvm::StringRef name) : Constraint(getBaseCPredKind(name)) {}
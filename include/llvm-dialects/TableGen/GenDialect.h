@@ -26,5 +26,6 @@ namespace llvm_dialects {
 
 void genDialectDecls(llvm::raw_ostream& out, llvm::RecordKeeper& records);
 void genDialectDefs(llvm::raw_ostream& out, llvm::RecordKeeper& records);
+void genDialectBench(llvm::raw_ostream& out, llvm::RecordKeeper& records);
 
 } // namespace llvm_dialects
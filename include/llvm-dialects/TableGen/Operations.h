@@ -44,6 +44,18 @@ struct OverloadKey {
   unsigned index;
 };
 
+/// Attributes that are attached to the call site when an attribute argument
+/// has the given value.
+struct OpConditionalAttributes {
+  /// Index of the attribute argument among the full arguments.
+  unsigned argIdx;
+  int64_t value;
+  Trait *trait;
+
+  /// Index into the dialect's attribute list array.
+  int attributeListIdx = -1;
+};
+
 class OpClass {
 public:
   OpClass *superclass = nullptr;
@@ -72,6 +84,24 @@ public:
   std::vector<OpNamedValue> results;
   std::vector<std::unique_ptr<PredicateExpr>> verifier;
   bool builderHasExplicitResultTypes = false;
+  std::vector<OpConditionalAttributes> conditionalAttributes;
+
+  /// Name of the llvm::Intrinsic::ID enumerator of intrinsic-backed
+  /// operations, or empty.
+  std::string intrinsic;
+
+  /// For intrinsic-backed operations: the index of the (full) operation
+  /// argument that is passed as each intrinsic argument.
+  std::vector<unsigned> intrinsicArgs;
+
+  bool isIntrinsic() const { return !intrinsic.empty(); }
+
+  /// Whether the last argument is variadic. Variadic arguments are passed as
+  /// trailing arguments of a vararg declaration.
+  bool hasVariadicArgument() const;
+
+  /// Return the call operand index at which the given (full) argument is found.
+  unsigned getArgOperandIdx(unsigned argIdx) const;
 
   llvm::ArrayRef<OverloadKey> overload_keys() const { return m_overloadKeys; }
   bool overload_keys_empty() const { return m_overloadKeys.empty(); }
@@ -15,9 +15,16 @@
  */
 
 #include "llvm-dialects/Dialect/Dialect.h"
+#include "llvm-dialects/Dialect/OpDescription.h"
+#include "llvm-dialects/Dialect/Utils.h"
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/ValueHandle.h"
+#include "llvm/IR/ValueMap.h"
+#include "llvm/IR/ValueSymbolTable.h"
 
 #include <atomic>
 #include <mutex>
@@ -149,6 +156,198 @@ void ContextMap::remove(LLVMContext *llvmContext,
 
 } // anonymous namespace
 
+namespace llvm_dialects::detail {
+
+/// Cache of overload declarations used by DialectContext::getOrInsertOverload.
+///
+/// Entries are keyed by the original declaration, and are dropped when it is
+/// deleted. Overloads may be deleted independently, so they are validated on
+/// lookup.
+class OverloadCache {
+public:
+  struct Entry {
+    SmallVector<Type *, 2> overloadTypes;
+    Type *resultType;
+    bool compact;
+    WeakVH overload;
+  };
+
+  // Declarations may be replaced by values that aren't functions, so entries
+  // don't follow RAUW.
+  struct KeyConfig : ValueMapConfig<Function *> {
+    enum { FollowRAUW = false };
+  };
+
+  ValueMap<Function *, SmallVector<Entry, 2>, KeyConfig> m_entries;
+};
+
+/// Per-module lists of declarations, used by DialectContext::forEachDeclaration.
+class DeclarationDirectory {
+public:
+  struct ModuleEntry {
+    /// Size of the module's symbol table and its last function when all of
+    /// its declarations were last known to be in the entry. Functions are
+    /// appended to their module, so declarations that are added by other
+    /// means than @ref note, e.g. by getOrInsertFunction, cause a rebuild.
+    /// The handle also dies with the module, so that a new module at the same
+    /// address is not mistaken for this one.
+    unsigned numSymbols = 0;
+    WeakVH last;
+
+    /// The declarations in the entry. Deleted functions may have their memory
+    /// re-used, so a key only refers to the same function while its handle is
+    /// non-null.
+    DenseMap<Function *, WeakVH> known;
+    StringMap<SmallVector<WeakVH, 4>> byDialect;
+    DenseMap<const OpDescription *, SmallVector<WeakVH, 2>> byOp;
+  };
+
+  /// Return the entry for @p module, (re-)building it if necessary.
+  ModuleEntry &get(Module &module);
+
+  /// Return the declarations of the operation described by @p desc.
+  ArrayRef<WeakVH> getOp(ModuleEntry &entry, const OpDescription &desc);
+
+  void note(Function *decl);
+
+  DenseMap<Module *, ModuleEntry> m_modules;
+
+private:
+  static bool add(ModuleEntry &entry, Function *decl);
+  static bool isFresh(const ModuleEntry &entry, Module &module);
+  void prune();
+};
+
+} // namespace llvm_dialects::detail
+
+/// Return the group in the declaration directory of the function or operation
+/// with the given name: the dialect prefix of the name.
+static StringRef getDirectoryGroup(StringRef name) {
+  size_t pos = name.find('.');
+  if (pos == StringRef::npos)
+    return {};
+  return name.take_front(pos);
+}
+
+static StringRef getDirectoryGroup(const OpDescription &desc) {
+  if (desc.isIntrinsic())
+    return "llvm";
+  return getDirectoryGroup(desc.getMnemonic());
+}
+
+/// Add @p decl to @p entry. Returns true if it was not in the entry before.
+bool llvm_dialects::detail::DeclarationDirectory::add(ModuleEntry &entry,
+                                                      Function *decl) {
+  StringRef group = getDirectoryGroup(decl->getName());
+  if (group.empty())
+    return false;
+
+  WeakVH &handle = entry.known[decl];
+  if (handle)
+    return false;
+  handle = decl;
+
+  entry.byDialect[group].push_back(decl);
+  for (auto &[desc, decls] : entry.byOp) {
+    if (desc->matchDeclaration(*decl))
+      decls.push_back(decl);
+  }
+  return true;
+}
+
+/// Drop the entries of modules that have no live declarations left. This is
+/// the case for modules that were destroyed without invalidating their entry,
+/// so that long-running processes don't accumulate entries. Other entries that
+/// are dropped are simply rebuilt on their next query.
+void llvm_dialects::detail::DeclarationDirectory::prune() {
+  SmallVector<Module *> dead;
+  for (auto &[module, entry] : m_modules) {
+    if (llvm::none_of(entry.known,
+                      [](const auto &known) { return bool(known.second); }))
+      dead.push_back(module);
+  }
+  for (Module *module : dead)
+    m_modules.erase(module);
+}
+
+static Function *getLastFunction(Module &module) {
+  return module.empty() ? nullptr : &module.getFunctionList().back();
+}
+
+/// Return whether @p entry still lists all declarations of @p module.
+bool llvm_dialects::detail::DeclarationDirectory::isFresh(
+    const ModuleEntry &entry, Module &module) {
+  if (entry.numSymbols != module.getValueSymbolTable().size())
+    return false;
+  return entry.last == getLastFunction(module);
+}
+
+llvm_dialects::detail::DeclarationDirectory::ModuleEntry &
+llvm_dialects::detail::DeclarationDirectory::get(Module &module) {
+  auto it = m_modules.find(&module);
+  if (it != m_modules.end() && isFresh(it->second, module))
+    return it->second;
+
+  if (it == m_modules.end()) {
+    prune();
+    it = m_modules.try_emplace(&module).first;
+  }
+
+  ModuleEntry &entry = it->second;
+  entry = ModuleEntry();
+  entry.numSymbols = module.getValueSymbolTable().size();
+  entry.last = getLastFunction(module);
+  for (Function &fn : module.functions()) {
+    if (fn.isDeclaration())
+      add(entry, &fn);
+  }
+  return entry;
+}
+
+ArrayRef<WeakVH>
+llvm_dialects::detail::DeclarationDirectory::getOp(ModuleEntry &entry,
+                                                   const OpDescription &desc) {
+  auto [it, inserted] = entry.byOp.try_emplace(&desc);
+  if (inserted) {
+    auto groupIt = entry.byDialect.find(getDirectoryGroup(desc));
+    if (groupIt != entry.byDialect.end()) {
+      for (Value *decl : groupIt->second) {
+        if (decl && desc.matchDeclaration(*cast<Function>(decl)))
+          it->second.push_back(decl);
+      }
+    }
+  }
+  return it->second;
+}
+
+void llvm_dialects::detail::DeclarationDirectory::note(Function *decl) {
+  // Modules are only added on first query, so that modules which are never
+  // visited don't cost anything.
+  Module &module = *decl->getParent();
+  auto it = m_modules.find(&module);
+  if (it == m_modules.end())
+    return;
+
+  // Whether the declaration is new is decided by membership: the symbol
+  // count can't tell, since other symbols may have been deleted meanwhile.
+  ModuleEntry &entry = it->second;
+  if (!add(entry, decl))
+    return;
+
+  // Only adopt the new symbol count and last function if the declaration
+  // accounts for all of the growth. Otherwise, declarations may have been
+  // added by other means, and the entry is rebuilt on the next query.
+  unsigned numSymbols = module.getValueSymbolTable().size();
+  Function *prev = decl->getIterator() == module.begin()
+                       ? nullptr
+                       : &*std::prev(decl->getIterator());
+  if (numSymbols == entry.numSymbols + 1 && decl == getLastFunction(module) &&
+      prev == entry.last) {
+    entry.numSymbols = numSymbols;
+    entry.last = decl;
+  }
+}
+
 void Dialect::anchor() {}
 
 SmallVectorImpl<Dialect::Key*>& Dialect::Key::getRegisteredKeys() {
@@ -177,7 +376,8 @@ Dialect::Key::~Key() {
 }
 
 DialectContext::DialectContext(LLVMContext& context, unsigned dialectArraySize)
-    : m_llvmContext(context), m_dialectArraySize(dialectArraySize) {
+    : m_llvmContext(context), m_dialectArraySize(dialectArraySize),
+      m_overloadCache(std::make_unique<detail::OverloadCache>()) {
   ContextMap::get().insert(&context, this);
 }
 
@@ -214,11 +414,111 @@ DialectContext& DialectContext::get(LLVMContext& context) {
   return *CurrentContextCache::get(&context);
 }
 
+std::string DialectContext::getOverloadName(StringRef mnemonic,
+                                            ArrayRef<Type *> overloadTypes) const {
+  if (m_compactOverloadNames)
+    return getCompactMangledName(mnemonic, overloadTypes);
+  return getMangledName(mnemonic, overloadTypes);
+}
+
+std::string DialectContext::getOverloadName(Module &module, StringRef mnemonic,
+                                            Type *resultType,
+                                            ArrayRef<Type *> overloadTypes) const {
+  std::string name = getOverloadName(mnemonic, overloadTypes);
+  if (m_compactOverloadNames) {
+    Function *existing = module.getFunction(name);
+    if (existing && existing->getReturnType() != resultType)
+      return getMangledName(mnemonic, overloadTypes);
+  }
+  return name;
+}
+
+Function *DialectContext::getOrInsertOverload(Function *decl, StringRef mnemonic,
+                                              Type *resultType,
+                                              ArrayRef<Type *> overloadTypes) {
+  Module &module = *decl->getParent();
+  auto &entries = m_overloadCache->m_entries[decl];
+
+  for (auto it = entries.begin(); it != entries.end();) {
+    auto *overload = cast_or_null<Function>(it->overload);
+    if (!overload || overload->getParent() != &module ||
+        !detail::isOverloadedOperationDecl(overload, mnemonic)) {
+      // Stale entry, because the overload was deleted or renamed.
+      it = entries.erase(it);
+      continue;
+    }
+    if (it->resultType == resultType &&
+        it->compact == m_compactOverloadNames &&
+        ArrayRef<Type *>(it->overloadTypes) == overloadTypes)
+      return overload;
+    ++it;
+  }
+
+  FunctionType *declType = decl->getFunctionType();
+  auto *fnType = FunctionType::get(resultType, declType->params(),
+                                   declType->isVarArg());
+  std::string mangledName =
+      getOverloadName(module, mnemonic, resultType, overloadTypes);
+  auto *overload = cast<Function>(
+      module.getOrInsertFunction(mangledName, fnType, decl->getAttributes())
+          .getCallee());
+
+  detail::OverloadCache::Entry entry;
+  entry.overloadTypes.assign(overloadTypes.begin(), overloadTypes.end());
+  entry.resultType = resultType;
+  entry.compact = m_compactOverloadNames;
+  entry.overload = overload;
+  entries.push_back(std::move(entry));
+  noteDeclaration(overload);
+  return overload;
+}
+
+void DialectContext::enableDeclarationDirectory(bool enable) {
+  if (!enable)
+    m_declarationDirectory.reset();
+  else if (!m_declarationDirectory)
+    m_declarationDirectory = std::make_unique<detail::DeclarationDirectory>();
+}
+
+void DialectContext::invalidateDeclarationDirectory(Module &module) {
+  if (m_declarationDirectory)
+    m_declarationDirectory->m_modules.erase(&module);
+}
+
+void DialectContext::noteDeclarationImpl(Value *callee) {
+  if (auto *decl = dyn_cast<Function>(callee))
+    m_declarationDirectory->note(decl);
+}
+
+void DialectContext::forEachDeclaration(Module &module,
+                                        const OpDescription &desc,
+                                        function_ref<void(Function &)> callback) {
+  // Collect the declarations first, so that the callback may add new ones.
+  SmallVector<Function *, 8> decls;
+  if (!m_declarationDirectory) {
+    for (Function &decl : module.functions()) {
+      if (decl.isDeclaration() && desc.matchDeclaration(decl))
+        decls.push_back(&decl);
+    }
+  } else {
+    auto &entry = m_declarationDirectory->get(module);
+    for (Value *decl : m_declarationDirectory->getOp(entry, desc)) {
+      if (decl)
+        decls.push_back(cast<Function>(decl));
+    }
+  }
+
+  for (Function *decl : decls)
+    callback(*decl);
+}
+
 bool llvm_dialects::detail::isSimpleOperationDecl(const Function *fn,
                                                   StringRef name) {
   return fn->getName() == name;
 }
 
+// Matches both full and compact overload names, since only the prefix is
+// checked.
 bool llvm_dialects::detail::isOverloadedOperationDecl(const Function *fn,
                                                       StringRef name) {
   StringRef fnName = fn->getName();
@@ -240,3 +540,10 @@ bool llvm_dialects::detail::isOverloadedOperation(const CallInst *i, StringRef n
     return isOverloadedOperationDecl(fn, name);
   return false;
 }
+
+bool llvm_dialects::detail::isIntrinsicOperation(const CallInst *i,
+                                                 unsigned intrinsicId) {
+  if (auto *fn = i->getCalledFunction())
+    return fn->getIntrinsicID() == intrinsicId;
+  return false;
+}
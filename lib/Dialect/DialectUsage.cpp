@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2023 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "llvm-dialects/Dialect/DialectUsage.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace llvm_dialects;
+using namespace llvm;
+
+// Summaries are stored as function metadata of the form
+//
+//   !llvm_dialects.usage !{i64 <schema hash>, i64 <bits 0..63>, ...}
+static constexpr const char *s_metadataKind = "llvm_dialects.usage";
+
+void DialectUsageSchema::addToHash(StringRef str) {
+  // Chain the hashes in a way that is independent of the host, so that
+  // summaries remain valid in bitcode that is moved between machines.
+  std::string data = utostr(m_hash);
+  data += ':';
+  data += str;
+  m_hash = xxHash64(data);
+}
+
+unsigned
+DialectUsageSchema::addDialect(StringRef name,
+                               ArrayRef<const OpDescription *> intrinsicOps) {
+  Family family;
+  family.dialectPrefix = (name + ".").str();
+  family.ops.assign(intrinsicOps.begin(), intrinsicOps.end());
+  std::string description = "dialect:" + family.dialectPrefix;
+  for (const OpDescription *op : intrinsicOps) {
+    description += op->getMnemonic();
+    description += ',';
+  }
+  addToHash(description);
+  m_families.push_back(std::move(family));
+  return m_families.size() - 1;
+}
+
+unsigned DialectUsageSchema::addOps(ArrayRef<const OpDescription *> ops) {
+  Family family;
+  family.ops.assign(ops.begin(), ops.end());
+  std::string description = "ops:";
+  for (const OpDescription *op : ops) {
+    description += op->getMnemonic();
+    description += ',';
+  }
+  addToHash(description);
+  m_families.push_back(std::move(family));
+  return m_families.size() - 1;
+}
+
+void DialectUsageSchema::matchDeclaration(Function &decl,
+                                          BitVector &families) const {
+  for (const auto &enumeratedFamily : llvm::enumerate(m_families)) {
+    const Family &family = enumeratedFamily.value();
+    bool match = !family.dialectPrefix.empty() &&
+                 decl.getName().startswith(family.dialectPrefix);
+    match = match || llvm::any_of(family.ops, [&](const OpDescription *op) {
+              return op->matchDeclaration(decl);
+            });
+    if (match)
+      families.set(enumeratedFamily.index());
+  }
+}
+
+static void setDialectUsage(Function &fn, const DialectUsageSchema &schema,
+                            const BitVector &families) {
+  LLVMContext &context = fn.getContext();
+  auto *i64 = Type::getInt64Ty(context);
+
+  SmallVector<uint64_t, 2> words((schema.size() + 63) / 64);
+  for (unsigned family : families.set_bits())
+    words[family / 64] |= uint64_t(1) << (family % 64);
+
+  SmallVector<Metadata *, 3> operands;
+  operands.push_back(
+      ConstantAsMetadata::get(ConstantInt::get(i64, schema.getHash())));
+  for (uint64_t word : words)
+    operands.push_back(ConstantAsMetadata::get(ConstantInt::get(i64, word)));
+
+  fn.setMetadata(s_metadataKind, MDTuple::get(context, operands));
+}
+
+bool llvm_dialects::getDialectUsage(const Function &fn,
+                                    const DialectUsageSchema &schema,
+                                    BitVector &families) {
+  MDNode *md = fn.getMetadata(s_metadataKind);
+  if (!md)
+    return false;
+
+  unsigned numWords = (schema.size() + 63) / 64;
+  if (md->getNumOperands() != 1 + numWords)
+    return false;
+
+  auto *hash = mdconst::dyn_extract<ConstantInt>(md->getOperand(0));
+  if (!hash || hash->getZExtValue() != schema.getHash())
+    return false;
+
+  families.clear();
+  families.resize(schema.size());
+  for (unsigned wordIdx = 0; wordIdx < numWords; ++wordIdx) {
+    auto *word = mdconst::dyn_extract<ConstantInt>(md->getOperand(1 + wordIdx));
+    if (!word)
+      return false;
+
+    uint64_t bits = word->getZExtValue();
+    for (unsigned bit = 0; bit < 64 && wordIdx * 64 + bit < schema.size();
+         ++bit) {
+      if (bits & (uint64_t(1) << bit))
+        families.set(wordIdx * 64 + bit);
+    }
+  }
+  return true;
+}
+
+static void computeDialectUsageImpl(Module &module,
+                                    const DialectUsageSchema &schema,
+                                    bool onlyMissing) {
+  DenseMap<Function *, BitVector> usage;
+  BitVector families;
+  for (Function &fn : module.functions()) {
+    if (fn.isDeclaration())
+      continue;
+    if (onlyMissing && getDialectUsage(fn, schema, families))
+      continue;
+    usage.try_emplace(&fn, schema.size());
+  }
+
+  if (usage.empty())
+    return;
+
+  // Walk the uses of dialect operation declarations instead of all
+  // instructions.
+  for (Function &decl : module.functions()) {
+    if (!decl.isDeclaration())
+      continue;
+
+    families.clear();
+    families.resize(schema.size());
+    schema.matchDeclaration(decl, families);
+    if (families.none())
+      continue;
+
+    for (Use &use : decl.uses()) {
+      if (auto *call = dyn_cast<CallInst>(use.getUser())) {
+        if (&use != &call->getCalledOperandUse())
+          continue;
+        auto it = usage.find(call->getFunction());
+        if (it != usage.end())
+          it->second |= families;
+      }
+    }
+  }
+
+  for (auto &[fn, fnFamilies] : usage)
+    setDialectUsage(*fn, schema, fnFamilies);
+}
+
+void llvm_dialects::computeDialectUsage(Module &module,
+                                        const DialectUsageSchema &schema) {
+  computeDialectUsageImpl(module, schema, false);
+}
+
+void llvm_dialects::refreshDialectUsage(Module &module,
+                                        const DialectUsageSchema &schema) {
+  computeDialectUsageImpl(module, schema, true);
+}
+
+void llvm_dialects::addDialectUsage(Function &fn,
+                                    const DialectUsageSchema &schema,
+                                    unsigned family) {
+  BitVector families;
+  if (!getDialectUsage(fn, schema, families) || families.test(family))
+    return;
+  families.set(family);
+  setDialectUsage(fn, schema, families);
+}
+
+void llvm_dialects::invalidateDialectUsage(Function &fn) {
+  fn.setMetadata(s_metadataKind, nullptr);
+}
+
+bool llvm_dialects::mayUseDialectFamily(const Function &fn,
+                                        const DialectUsageSchema &schema,
+                                        unsigned family) {
+  BitVector families;
+  if (!getDialectUsage(fn, schema, families))
+    return true;
+  return families.test(family);
+}
+
+PreservedAnalyses DialectUsagePass::run(Module &module,
+                                        ModuleAnalysisManager &) {
+  refreshDialectUsage(module, m_schema);
+  return PreservedAnalyses::all();
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "llvm-dialects/Dialect/OpCountInstrumentation.h"
+
+#include "llvm-dialects/Dialect/OpDescription.h"
+
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Transforms/Utils/ModuleUtils.h"
+
+using namespace llvm_dialects;
+using namespace llvm;
+
+static constexpr const char *s_countersName = "llvm_dialects.op_counts";
+static constexpr const char *s_dumpName = "llvm_dialects.dump_op_counts";
+
+/// Define the function that prints all counters.
+static Function *createDumpFunction(Module &module, GlobalVariable *counters,
+                                    ArrayRef<const OpDescription *> ops) {
+  LLVMContext &context = module.getContext();
+  IRBuilder<> b{context};
+
+  // Internal like the counters, so that instrumented modules can be linked.
+  Function *dump =
+      Function::Create(FunctionType::get(b.getVoidTy(), false),
+                       GlobalValue::InternalLinkage, s_dumpName, module);
+  b.SetInsertPoint(BasicBlock::Create(context, "entry", dump));
+
+  FunctionCallee printf = module.getOrInsertFunction(
+      "printf", FunctionType::get(b.getInt32Ty(),
+                                  {PointerType::get(context, 0)}, true));
+  Value *format = b.CreateGlobalStringPtr("%s: %llu\n", "op_count.fmt");
+
+  for (const auto &enumeratedOp : llvm::enumerate(ops)) {
+    Value *name =
+        b.CreateGlobalStringPtr(enumeratedOp.value()->getMnemonic(), "op_count.name");
+    Value *counter = b.CreateConstInBoundsGEP2_32(
+        counters->getValueType(), counters, 0, enumeratedOp.index());
+    Value *count = b.CreateLoad(b.getInt64Ty(), counter);
+    b.CreateCall(printf, {format, name, count});
+  }
+
+  b.CreateRetVoid();
+  return dump;
+}
+
+bool llvm_dialects::instrumentOpCounts(Module &module,
+                                       ArrayRef<const OpDescription *> ops,
+                                       bool dumpAtExit) {
+  if (ops.empty() || module.getNamedGlobal(s_countersName))
+    return false;
+
+  LLVMContext &context = module.getContext();
+  IRBuilder<> b{context};
+
+  auto *countersTy = ArrayType::get(b.getInt64Ty(), ops.size());
+  auto *counters = new GlobalVariable(module, countersTy, false,
+                                      GlobalValue::InternalLinkage,
+                                      Constant::getNullValue(countersTy),
+                                      s_countersName);
+
+  // Collect the call sites first so that the module is not modified while we
+  // iterate over it.
+  SmallVector<std::pair<CallInst *, unsigned>> callSites;
+  for (Function &decl : module.functions()) {
+    if (!decl.isDeclaration())
+      continue;
+
+    for (const auto &enumeratedOp : llvm::enumerate(ops)) {
+      if (!enumeratedOp.value()->matchDeclaration(decl))
+        continue;
+
+      for (Use &use : decl.uses()) {
+        if (auto *call = dyn_cast<CallInst>(use.getUser())) {
+          if (&use == &call->getCalledOperandUse())
+            callSites.emplace_back(call, enumeratedOp.index());
+        }
+      }
+      break;
+    }
+  }
+
+  for (const auto &[call, index] : callSites) {
+    b.SetInsertPoint(call);
+    Value *counter =
+        b.CreateConstInBoundsGEP2_32(countersTy, counters, 0, index);
+    b.CreateAtomicRMW(AtomicRMWInst::Add, counter, b.getInt64(1), MaybeAlign(),
+                      AtomicOrdering::Monotonic);
+  }
+
+  Function *dump = createDumpFunction(module, counters, ops);
+  if (dumpAtExit)
+    appendToGlobalDtors(module, dump, 65535);
+  return true;
+}
+
+PreservedAnalyses OpCountInstrumentationPass::run(Module &module,
+                                                  ModuleAnalysisManager &) {
+  if (!instrumentOpCounts(module, m_ops, m_dumpAtExit))
+    return PreservedAnalyses::all();
+  return PreservedAnalyses::none();
+}
@@ -18,6 +18,7 @@
 
 #include "llvm-dialects/Dialect/Dialect.h"
 
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
 
@@ -33,7 +34,13 @@ bool OpDescription::matchInstruction(Instruction &inst) const {
 }
 
 bool OpDescription::matchDeclaration(Function &decl) const {
+  if (isIntrinsic())
+    return decl.getIntrinsicID() == m_intrinsicId;
   if (m_hasOverloads)
     return llvm_dialects::detail::isOverloadedOperationDecl(&decl, m_mnemonic);
   return llvm_dialects::detail::isSimpleOperationDecl(&decl, m_mnemonic);
 }
+
+bool OpDescription::isAttributeOperand(unsigned argIdx) const {
+  return llvm::is_contained(m_attributeOperands, argIdx);
+}
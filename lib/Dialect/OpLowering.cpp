@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2023 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "llvm-dialects/Dialect/OpLowering.h"
+
+#include "llvm-dialects/Dialect/Builder.h"
+
+#include "llvm/IR/Module.h"
+
+#include <map>
+
+using namespace llvm_dialects;
+using namespace llvm;
+
+static constexpr const char *s_loweredAttr = "llvm_dialects.lowered";
+static constexpr const char *s_helperPrefix = "llvm_dialects.lowered.";
+
+OpLowering &OpLowering::add(const OpDescription &desc,
+                            Callback<CallInst> callback) {
+  m_entries.push_back({&desc, std::move(callback)});
+  return *this;
+}
+
+/// Run the lowering callback on @p op and replace it by the returned value.
+static void lowerInline(Builder &b, CallInst &op,
+                        const OpLowering::Callback<CallInst> &callback) {
+  b.SetInsertPoint(&op);
+  if (Value *replacement = callback(b, op))
+    op.replaceAllUsesWith(replacement);
+  op.eraseFromParent();
+}
+
+/// Distinct instantiations of an operation: the callee, the types of all
+/// arguments (which covers overloads via varargs) and the values of attribute
+/// arguments.
+using InstantiationKey = SmallVector<const void *, 8>;
+
+static InstantiationKey getInstantiationKey(const OpDescription &desc,
+                                            CallInst &op) {
+  InstantiationKey key;
+  key.push_back(op.getCalledFunction());
+  for (const Use &arg : op.args()) {
+    key.push_back(arg->getType());
+    if (desc.isAttributeOperand(op.getArgOperandNo(&arg)))
+      key.push_back(arg.get());
+  }
+  return key;
+}
+
+/// Create a helper function that contains the lowering of @p op.
+static Function *createHelper(Builder &b, const OpDescription &desc,
+                              CallInst &op,
+                              const OpLowering::Callback<CallInst> &callback) {
+  Module &module = *op.getModule();
+  Function *decl = op.getCalledFunction();
+
+  SmallVector<Type *> paramTypes;
+  for (const Use &arg : op.args()) {
+    if (!desc.isAttributeOperand(op.getArgOperandNo(&arg)))
+      paramTypes.push_back(arg->getType());
+  }
+
+  // Prefix rather than suffix the name of the declaration: names of intrinsics
+  // and of overloaded operations are matched by prefix, and the helper must
+  // not be mistaken for either.
+  Function *helper = Function::Create(
+      FunctionType::get(op.getType(), paramTypes, false),
+      GlobalValue::InternalLinkage, s_helperPrefix + decl->getName(),
+      module);
+  helper->addFnAttr(s_loweredAttr, decl->getName());
+
+  BasicBlock *entry = BasicBlock::Create(module.getContext(), "entry", helper);
+
+  // Build a copy of the operation in the helper, so that the callback can use
+  // the usual accessors.
+  b.SetInsertPoint(entry);
+  CallInst *proto = b.Insert(cast<CallInst>(op.clone()));
+  proto->setDebugLoc({});
+  unsigned paramIdx = 0;
+  for (Use &arg : proto->args()) {
+    if (!desc.isAttributeOperand(proto->getArgOperandNo(&arg)))
+      arg.set(helper->getArg(paramIdx++));
+  }
+
+  if (op.getType()->isVoidTy())
+    b.CreateRetVoid();
+  else
+    b.CreateRet(proto);
+
+  lowerInline(b, *proto, callback);
+  return helper;
+}
+
+unsigned OpLowering::run(Module &module) const {
+  Builder b{module.getContext()};
+  std::map<InstantiationKey, Function *> helpers;
+  unsigned numLowered = 0;
+
+  for (const Entry &entry : m_entries) {
+    // Collect the operations first, since lowering may add new functions to
+    // the module.
+    SmallVector<CallInst *> ops;
+    b.getDialectContext().forEachDeclaration(
+        module, *entry.desc, [&](Function &decl) {
+          for (Use &use : decl.uses()) {
+            if (auto *call = dyn_cast<CallInst>(use.getUser())) {
+              if (&use == &call->getCalledOperandUse() &&
+                  (!entry.match || entry.match(*call)))
+                ops.push_back(call);
+            }
+          }
+        });
+
+    for (CallInst *op : ops) {
+      ++numLowered;
+      if (m_mode == LoweringMode::Inline) {
+        lowerInline(b, *op, entry.callback);
+        continue;
+      }
+
+      Function *&helper = helpers[getInstantiationKey(*entry.desc, *op)];
+      if (!helper)
+        helper = createHelper(b, *entry.desc, *op, entry.callback);
+
+      SmallVector<Value *> args;
+      for (const Use &arg : op->args()) {
+        if (!entry.desc->isAttributeOperand(op->getArgOperandNo(&arg)))
+          args.push_back(arg.get());
+      }
+
+      b.SetInsertPoint(op);
+      CallInst *call = b.CreateCall(helper, args);
+      call->setDebugLoc(op->getDebugLoc());
+      call->takeName(op);
+      op->replaceAllUsesWith(call);
+      op->eraseFromParent();
+    }
+  }
+
+  return numLowered;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2023 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "llvm-dialects/Dialect/PureOpInliner.h"
+
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+
+using namespace llvm_dialects;
+using namespace llvm;
+
+/// Check whether @p call is a call of a pure operation of one of the dialects.
+static bool isPureDialectOp(const CallInst &call, ArrayRef<StringRef> dialects) {
+  const Function *callee = call.getCalledFunction();
+  if (!callee || !callee->isDeclaration() || callee->isIntrinsic())
+    return false;
+
+  StringRef name = callee->getName();
+  bool inDialect = llvm::any_of(dialects, [&](StringRef dialect) {
+    return name.size() > dialect.size() && name.startswith(dialect) &&
+           name[dialect.size()] == '.';
+  });
+  if (!inDialect)
+    return false;
+
+  // The call site queries fall back to the attributes of the declaration.
+  return call.doesNotAccessMemory() && call.willReturn() &&
+         call.doesNotThrow();
+}
+
+bool llvm_dialects::isTriviallyInlinable(const Function &fn,
+                                         ArrayRef<StringRef> dialects,
+                                         unsigned maxOps) {
+  if (fn.isDeclaration() || fn.isInterposable() || fn.isVarArg() ||
+      fn.hasFnAttribute(Attribute::NoInline) ||
+      fn.hasFnAttribute(Attribute::OptimizeNone) || fn.size() != 1)
+    return false;
+
+  unsigned numOps = 0;
+  for (const Instruction &inst : fn.getEntryBlock()) {
+    if (isa<DbgInfoIntrinsic>(inst))
+      continue;
+    if (isa<ReturnInst>(inst))
+      return true;
+
+    const auto *call = dyn_cast<CallInst>(&inst);
+    if (!call || !isPureDialectOp(*call, dialects) || ++numOps > maxOps)
+      return false;
+  }
+  return false;
+}
+
+bool llvm_dialects::inlinePureDialectFunctions(Module &module,
+                                               ArrayRef<StringRef> dialects,
+                                               unsigned maxOps) {
+  // Classify all functions up front, so that the result does not depend on the
+  // order in which call sites are inlined.
+  SmallVector<Function *> inlinable;
+  for (Function &fn : module.functions()) {
+    if (isTriviallyInlinable(fn, dialects, maxOps))
+      inlinable.push_back(&fn);
+  }
+
+  bool changed = false;
+  for (Function *fn : inlinable) {
+    SmallVector<CallInst *> calls;
+    for (Use &use : fn->uses()) {
+      auto *call = dyn_cast<CallInst>(use.getUser());
+      if (call && &use == &call->getCalledOperandUse() &&
+          call->getFunctionType() == fn->getFunctionType() &&
+          !call->isNoInline() && !call->isMustTailCall() &&
+          call->getFunction() != fn)
+        calls.push_back(call);
+    }
+
+    for (CallInst *call : calls) {
+      InlineFunctionInfo info;
+      if (InlineFunction(*call, info).isSuccess())
+        changed = true;
+    }
+
+    if (fn->use_empty() && fn->isDiscardableIfUnused()) {
+      fn->eraseFromParent();
+      changed = true;
+    }
+  }
+
+  return changed;
+}
+
+PreservedAnalyses PureOpInlinerPass::run(Module &module,
+                                         ModuleAnalysisManager &) {
+  SmallVector<StringRef> dialects(m_dialects.begin(), m_dialects.end());
+  if (!inlinePureDialectFunctions(module, dialects, m_maxOps))
+    return PreservedAnalyses::all();
+  return PreservedAnalyses::none();
+}
@@ -16,9 +16,17 @@
 
 #include "llvm-dialects/Dialect/Utils.h"
 
+#include "llvm-dialects/Dialect/Builder.h"
+#include "llvm-dialects/Dialect/OpDescription.h"
+
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 
 using namespace llvm;
 using namespace llvm_dialects;
@@ -118,3 +126,68 @@ std::string llvm_dialects::getMangledName(StringRef name,
   }
   return result;
 }
+
+std::string llvm_dialects::getCompactMangledName(StringRef name,
+                                                 ArrayRef<Type *> overloadTypes) {
+  std::string mangled = getMangledName(name, overloadTypes);
+  StringRef suffix = StringRef(mangled).drop_front(name.size());
+
+  // Mangled type names never start with '_', so compact names cannot collide
+  // with full ones.
+  static constexpr unsigned s_numHashDigits = 12;
+  if (suffix.size() <= 2 + s_numHashDigits)
+    return mangled;
+
+  uint64_t hash = xxHash64(suffix) & ((uint64_t(1) << (4 * s_numHashDigits)) - 1);
+  std::string result = name.str();
+  raw_string_ostream out(result);
+  out << "._" << format_hex_no_prefix(hash, s_numHashDigits);
+  return out.str();
+}
+
+CallInst *llvm_dialects::cloneDialectOp(Builder &builder, CallInst &op,
+                                        const OpDescription &desc,
+                                        Type *resultType,
+                                        ArrayRef<Type *> overloadTypes) {
+  assert(desc.hasOverloads());
+  Function *decl = op.getCalledFunction();
+  assert(decl && desc.matchDeclaration(*decl));
+
+  Function *overload = builder.getDialectContext().getOrInsertOverload(
+      decl, desc.getMnemonic(), resultType, overloadTypes);
+
+  // Cloning preserves operands, attributes, operand bundles, metadata and the
+  // debug location.
+  auto *clone = cast<CallInst>(op.clone());
+  clone->mutateType(resultType);
+  clone->setCalledFunction(overload);
+  builder.Insert(clone);
+
+  // Inserting via the builder may have overwritten the debug location.
+  clone->copyMetadata(op);
+  return clone;
+}
+
+CallInst *llvm_dialects::createIntrinsicCall(Builder &builder,
+                                             unsigned intrinsicId,
+                                             Type *resultType,
+                                             ArrayRef<Value *> args) {
+  SmallVector<Type *> argTypes;
+  for (Value *arg : args)
+    argTypes.push_back(arg->getType());
+  FunctionType *fnType = FunctionType::get(resultType, argTypes, false);
+
+  SmallVector<Intrinsic::IITDescriptor> table;
+  Intrinsic::getIntrinsicInfoTableEntries(intrinsicId, table);
+  ArrayRef<Intrinsic::IITDescriptor> tableRef = table;
+  SmallVector<Type *> overloadTypes;
+  [[maybe_unused]] Intrinsic::MatchIntrinsicTypesResult match =
+      Intrinsic::matchIntrinsicSignature(fnType, tableRef, overloadTypes);
+  assert(match == Intrinsic::MatchIntrinsicTypes_Match &&
+         "arguments do not match the intrinsic signature");
+
+  Module &module = *builder.GetInsertBlock()->getModule();
+  Function *decl = Intrinsic::getDeclaration(&module, intrinsicId, overloadTypes);
+  builder.getDialectContext().noteDeclaration(decl);
+  return builder.CreateCall(decl, args);
+}
@@ -16,6 +16,8 @@
 
 #include "llvm-dialects/Dialect/Visitor.h"
 
+#include "llvm-dialects/Dialect/Dialect.h"
+
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
@@ -28,6 +30,7 @@ using namespace llvm;
 
 using llvm_dialects::detail::VisitorBuilderBase;
 using llvm_dialects::detail::VisitorBase;
+using llvm_dialects::detail::VisitorCase;
 
 void VisitorBuilderBase::add(const OpDescription &desc, void *extra, VisitorCallback *fn) {
   m_cases.emplace_back(&desc, extra, fn);
@@ -37,7 +40,38 @@ VisitorBase::VisitorBase(VisitorBuilderBase builder)
     : m_strategy(builder.m_strategy), m_cases(std::move(builder.m_cases)) {
 }
 
-void VisitorBase::visit(void *payload, Function &fn) const {
+/// Call @p callback for each declaration in @p module that matches one of the
+/// @p cases.
+///
+/// If the declaration directory of @p dialectContext is enabled, the matching
+/// declarations are looked up case by case. Otherwise, all declarations of the
+/// module are scanned in order, and matched against each case.
+static void
+forEachCaseDeclaration(Module &module, DialectContext *dialectContext,
+                       ArrayRef<VisitorCase> cases,
+                       function_ref<void(const VisitorCase &, Function &)> callback) {
+  if (dialectContext && dialectContext->isDeclarationDirectoryEnabled()) {
+    for (const auto &visitorCase : cases) {
+      dialectContext->forEachDeclaration(
+          module, *std::get<0>(visitorCase),
+          [&](Function &decl) { callback(visitorCase, decl); });
+    }
+    return;
+  }
+
+  for (Function &decl : module.functions()) {
+    if (!decl.isDeclaration())
+      continue;
+
+    for (const auto &visitorCase : cases) {
+      if (std::get<0>(visitorCase)->matchDeclaration(decl))
+        callback(visitorCase, decl);
+    }
+  }
+}
+
+void VisitorBase::visit(void *payload, Function &fn,
+                        DialectContext *dialectContext) const {
   if (m_strategy == VisitorStrategy::ByInstruction) {
     for (BasicBlock &bb : fn) {
       for (Instruction &inst : bb) {
@@ -50,14 +84,12 @@ void VisitorBase::visit(void *payload, Function &fn) const {
     return;
   }
 
-  for (Function &decl : fn.getParent()->functions()) {
-    if (!decl.isDeclaration())
-      continue;
+  forEachCaseDeclaration(
+      *fn.getParent(), dialectContext, m_cases,
+      [&](const VisitorCase &visitorCase, Function &decl) {
+        const auto &[desc, extra, callback] = visitorCase;
+        LLVM_DEBUG(dbgs() << "visit " << decl.getName() << '\n');
 
-    LLVM_DEBUG(dbgs() << "visit " << decl.getName() << '\n');
-
-    for (const auto &[desc, extra, callback] : m_cases) {
-      if (desc->matchDeclaration(decl)) {
         for (Use &use : decl.uses()) {
           if (auto *inst = dyn_cast<Instruction>(use.getUser())) {
             if (inst->getFunction() != &fn)
@@ -68,12 +100,11 @@ void VisitorBase::visit(void *payload, Function &fn) const {
             }
           }
         }
-      }
-    }
-  }
+      });
 }
 
-void VisitorBase::visit(void *payload, Module &module) const {
+void VisitorBase::visit(void *payload, Module &module,
+                        DialectContext *dialectContext) const {
   if (m_strategy == VisitorStrategy::ByInstruction) {
     for (Function &fn : module.functions()) {
       if (!fn.isDeclaration())
@@ -82,19 +113,15 @@ void VisitorBase::visit(void *payload, Module &module) const {
     return;
   }
 
-  for (Function &decl : module.functions()) {
-    if (!decl.isDeclaration())
-      continue;
-
-    for (const auto &[desc, extra, callback] : m_cases) {
-      if (desc->matchDeclaration(decl)) {
+  forEachCaseDeclaration(
+      module, dialectContext, m_cases,
+      [&](const VisitorCase &visitorCase, Function &decl) {
+        const auto &[desc, extra, callback] = visitorCase;
         for (Use &use : decl.uses()) {
           if (auto *call = dyn_cast<CallInst>(use.getUser())) {
             if (&use == &call->getCalledOperandUse())
               callback(extra, payload, call);
           }
         }
-      }
-    }
-  }
+      });
 }
@@ -77,6 +77,17 @@ void Attr::init(GenDialectsContext *context, llvm::Record *record) {
   m_fromLlvmValue = record->getValueAsString("fromLlvmValue");
 }
 
+void Variadic::init(GenDialectsContext *context, llvm::Record *record) {
+  Constraint::init(context, record);
+
+  m_elementType = context->getConstraint(record->getValueAsDef("elementType"));
+  if (!isa<Type>(m_elementType) && !isa<BaseCPred>(m_elementType)) {
+    report_fatal_error(Twine("Variadic '") + record->getName() +
+                       "' has element type '" + m_elementType->getName() +
+                       "' which is neither a Type nor a predicate");
+  }
+}
+
 void BaseCPred::init(GenDialectsContext *context, llvm::Record *record) {
   Constraint::init(context, record);
 
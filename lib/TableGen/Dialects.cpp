@@ -58,6 +58,21 @@ void GenDialect::finalize() {
     }
     op->m_attributeListIdx = m_attributeLists.size() - 1;
   }
+
+  // Conditional attributes are attached to call sites and consist of only the
+  // conditional trait.
+  for (const auto &op : operations) {
+    for (OpConditionalAttributes &conditional : op->conditionalAttributes) {
+      std::vector<Trait *> traits{conditional.trait};
+      auto it = llvm::find(m_attributeLists, traits);
+      if (it == m_attributeLists.end()) {
+        m_attributeLists.push_back(std::move(traits));
+        it = std::prev(m_attributeLists.end());
+      }
+      conditional.attributeListIdx =
+          std::distance(m_attributeLists.begin(), it);
+    }
+  }
 }
 
 Trait *GenDialectsContext::getTrait(Record *traitRec) {
@@ -86,6 +101,8 @@ Constraint *GenDialectsContext::getConstraint(Record *constraintRec) {
       result = std::make_unique<DialectType>();
     } else if (constraintRec->isSubClassOf("Attr")) {
       result = std::make_unique<Attr>();
+    } else if (constraintRec->isSubClassOf("Variadic")) {
+      result = std::make_unique<Variadic>();
     } else if (constraintRec->isSubClassOf("BaseCPred")) {
       result = std::make_unique<BaseCPred>(constraintRec->getName());
     } else {
@@ -139,6 +156,16 @@ std::vector<OpNamedValue> GenDialectsContext::parseArguments(Record *rec) {
       report_fatal_error(Twine(rec->getName()) + " argument " + Twine(i) +
                          ": bad type constraint");
     }
+    if (isa<Variadic>(opArg.type)) {
+      if (rec->isSubClassOf("OpClass")) {
+        report_fatal_error(Twine(rec->getName()) +
+                           ": operation classes cannot have variadic arguments");
+      }
+      if (i + 1 != argsInit->getNumArgs()) {
+        report_fatal_error(Twine(rec->getName()) +
+                           ": variadic argument must be last");
+      }
+    }
     arguments.push_back(std::move(opArg));
   }
 
@@ -216,11 +243,80 @@ void GenDialectsContext::init(RecordKeeper &records,
       op->superclass->operations.push_back(op.get());
     op->name = opRec->getName();
     op->mnemonic = opRec->getValueAsString("mnemonic");
-    for (Record *traitRec : opRec->getValueAsListOfDefs("traits"))
-      op->traits.push_back(getTrait(traitRec));
+    SmallVector<Record *> conditionalTraitRecs;
+    for (Record *traitRec : opRec->getValueAsListOfDefs("traits")) {
+      if (traitRec->isSubClassOf("MemoryIf"))
+        conditionalTraitRecs.push_back(traitRec);
+      else
+        op->traits.push_back(getTrait(traitRec));
+    }
 
     op->arguments = parseArguments(opRec);
 
+    SmallVector<OpNamedValue> fullArguments = op->getFullArguments();
+    for (Record *traitRec : conditionalTraitRecs) {
+      StringRef attrName = traitRec->getValueAsString("attr");
+      auto it = llvm::find_if(fullArguments, [&](const OpNamedValue &arg) {
+        return arg.name == attrName;
+      });
+      if (it == fullArguments.end() || !isa<Attr>(it->type)) {
+        report_fatal_error(Twine("Operation '") + op->mnemonic +
+                           "': conditional trait refers to '" + attrName +
+                           "', which is not an attribute argument");
+      }
+
+      OpConditionalAttributes conditional;
+      conditional.argIdx = std::distance(fullArguments.begin(), it);
+      conditional.value = traitRec->getValueAsInt("value");
+      conditional.trait = getTrait(traitRec);
+      op->conditionalAttributes.push_back(conditional);
+    }
+
+    op->intrinsic = opRec->getValueAsString("intrinsic");
+    std::vector<StringRef> intrinsicArgs =
+        opRec->getValueAsListOfStrings("intrinsicArgs");
+    if (!op->isIntrinsic()) {
+      if (!intrinsicArgs.empty()) {
+        report_fatal_error(Twine("Operation '") + op->mnemonic +
+                           "' has intrinsicArgs but no intrinsic");
+      }
+    } else {
+      if (op->superclass) {
+        report_fatal_error(Twine("Intrinsic-backed operation '") +
+                           op->mnemonic + "' cannot have a superclass");
+      }
+      if (op->hasVariadicArgument()) {
+        report_fatal_error(Twine("Intrinsic-backed operation '") +
+                           op->mnemonic + "' cannot have variadic arguments");
+      }
+      if (!op->traits.empty() || !op->conditionalAttributes.empty()) {
+        report_fatal_error(Twine("Intrinsic-backed operation '") +
+                           op->mnemonic + "' cannot have traits");
+      }
+
+      if (intrinsicArgs.empty()) {
+        for (unsigned i = 0; i < op->arguments.size(); ++i)
+          op->intrinsicArgs.push_back(i);
+      }
+      for (StringRef name : intrinsicArgs) {
+        auto it = llvm::find_if(op->arguments, [&](const OpNamedValue &arg) {
+          return arg.name == name;
+        });
+        if (it == op->arguments.end()) {
+          report_fatal_error(Twine("Operation '") + op->mnemonic +
+                             "': unknown intrinsic argument '" + name + "'");
+        }
+        op->intrinsicArgs.push_back(std::distance(op->arguments.begin(), it));
+      }
+      for (unsigned i = 0; i < op->arguments.size(); ++i) {
+        if (!llvm::is_contained(op->intrinsicArgs, i)) {
+          report_fatal_error(Twine("Operation '") + op->mnemonic +
+                             "': argument '" + op->arguments[i].name +
+                             "' is not passed to the intrinsic");
+        }
+      }
+    }
+
     DagInit *results = opRec->getValueAsDag("results");
     assert(results->getOperatorAsDef({})->getName() == "outs");
     assert(results->getNumArgs() <= 1 &&
@@ -253,8 +349,11 @@ void GenDialectsContext::init(RecordKeeper &records,
     // Derive the overload keys: Scan through results and arguments. Whenever
     // we encounter one whose type isn't fully specified, add it to the overload
     // keys unless an equal type has already been added.
+    // Variadic arguments make the declaration vararg, which already allows
+    // arbitrary element types.
     auto needsOverloadKey = [&](const OpNamedValue &namedValue) -> bool {
-      if (isa<Type>(namedValue.type) || isa<Attr>(namedValue.type))
+      if (isa<Type>(namedValue.type) || isa<Attr>(namedValue.type) ||
+          isa<Variadic>(namedValue.type))
         return false;
 
       for (const auto &expr : op->verifier) {
@@ -296,6 +395,19 @@ void GenDialectsContext::init(RecordKeeper &records,
       }
     }
 
+    if (op->isIntrinsic()) {
+      // Operations are recognized by the intrinsic ID of their callee, so two
+      // operations of the same dialect cannot share an intrinsic.
+      for (const auto &other : dialectIt->second->operations) {
+        if (other->intrinsic == op->intrinsic) {
+          report_fatal_error(Twine("Operations '") + other->mnemonic +
+                             "' and '" + op->mnemonic +
+                             "' are both backed by intrinsic '" +
+                             op->intrinsic + "'");
+        }
+      }
+    }
+
     dialectIt->second->operations.push_back(std::move(op));
   }
 
@@ -95,9 +95,18 @@ public:
 StringRef Constraint::getCppType() const {
   if (auto* attr = dyn_cast<Attr>(this))
     return attr->getCppType();
+  if (isa<Variadic>(this))
+    return "::llvm::ArrayRef<::llvm::Value*>";
   return "::llvm::Value *";
 }
 
+/// Return the C++ type returned by the getter of an argument.
+static StringRef getGetterCppType(const Constraint* constraint) {
+  if (isa<Variadic>(constraint))
+    return "::llvm::User::op_range";
+  return constraint->getCppType();
+}
+
 static std::pair<GenDialectsContext, GenDialect *>
 getSelectedDialect(RecordKeeper &records) {
   if (g_dialect.empty())
@@ -128,6 +137,7 @@ void llvm_dialects::genDialectDecls(raw_ostream& out, RecordKeeper& records) {
 #ifdef GET_INCLUDES
 #undef GET_INCLUDES
 #include "llvm/IR/Instructions.h"
+#include "llvm/IR/Intrinsics.h"
 #include "llvm-dialects/Dialect/Dialect.h"
 #endif // GET_INCLUDES
 
@@ -162,6 +172,16 @@ class Builder;
       $Dialect(::llvm::LLVMContext& context);
 
       static ::llvm_dialects::Dialect* make(::llvm::LLVMContext& context);
+
+    public:
+      static ::llvm::StringRef getName() { return "$dialect"; }
+
+      // Operations that are represented as LLVM intrinsic calls. Their
+      // declarations are named after the intrinsic rather than the dialect,
+      // so code that finds operations by the dialect's name prefix must
+      // handle them separately.
+      static ::llvm::ArrayRef<const ::llvm_dialects::OpDescription*>
+      getIntrinsicOps();
   )",
                &fmt);
 
@@ -239,13 +259,44 @@ class Builder;
     fmt.withOp(op.name);
     fmt.addSubst("mnemonic", op.mnemonic);
 
+    std::string classofExpr;
+    if (op.isIntrinsic()) {
+      classofExpr = "::llvm_dialects::detail::isIntrinsicOperation(i, "
+                    "::llvm::Intrinsic::" +
+                    op.intrinsic + ")";
+
+      // The intrinsic may be overloaded more widely than the operation, so
+      // check the types that the operation fixes.
+      FmtContextScope contextScope{fmt};
+      fmt.withContext("i->getContext()");
+      auto addTypeCheck = [&](Constraint *constraint, StringRef typeExpr) {
+        if (auto *attr = dyn_cast<Attr>(constraint))
+          constraint = attr->getLlvmType();
+        if (auto *type = dyn_cast<BuiltinType>(constraint))
+          classofExpr += " &&\n" + type->apply(&fmt, {typeExpr});
+      };
+      for (const auto &result : op.results)
+        addTypeCheck(result.type, "i->getType()");
+      for (auto indexedArg : llvm::enumerate(op.getFullArguments())) {
+        addTypeCheck(indexedArg.value().type,
+                     "i->getArgOperand(" +
+                         std::to_string(op.getArgOperandIdx(
+                             indexedArg.index())) +
+                         ")->getType()");
+      }
+    } else if (op.haveResultOverloadKey()) {
+      classofExpr = "::llvm_dialects::detail::isOverloadedOperation(i, s_name)";
+    } else {
+      classofExpr = "::llvm_dialects::detail::isSimpleOperation(i, s_name)";
+    }
+
     out << tgfmt(R"(
       class $_op : public $0 {
         static const ::llvm::StringLiteral s_name; //{"$dialect.$mnemonic"};
 
       public:
         static bool classof(const ::llvm::CallInst* i) {
-          return ::llvm_dialects::detail::$1(i, s_name);
+          return $1;
         }
         static bool classof(const ::llvm::Value* v) {
           return ::llvm::isa<::llvm::CallInst>(v) &&
@@ -253,8 +304,7 @@ class Builder;
         }
     )",
                  &fmt, op.superclass ? op.superclass->name : "::llvm::CallInst",
-                 !op.haveResultOverloadKey() ? "isSimpleOperation"
-                                             : "isOverloadedOperation");
+                 classofExpr);
 
     SymbolTable symbols;
     SmallVector<OpNamedValue> fullArguments = op.getFullArguments();
@@ -280,8 +330,14 @@ class Builder;
       out << tgfmt(", $0 $1", &fmt, arg.type->getCppType(), argName);
     out << ");\n\n";
 
+    if (op.haveResultOverloadKey() && !op.isIntrinsic()) {
+      out << tgfmt("$_op* cloneWithTypes(::llvm_dialects::Builder& b, "
+                   "::llvm::ArrayRef<::llvm::Type*> overloadTypes);\n\n",
+                   &fmt);
+    }
+
     for (const auto& arg : op.arguments) {
-      out << tgfmt("$0 get$1();\n", &fmt, arg.type->getCppType(),
+      out << tgfmt("$0 get$1();\n", &fmt, getGetterCppType(arg.type),
                    convertToCamelFromSnakeCase(arg.name, true));
     }
 
@@ -331,6 +387,57 @@ void llvm_dialects::genDialectDefs(raw_ostream& out, RecordKeeper& records) {
   fmt.addSubst("dialect", dialect->name);
   fmt.addSubst("namespace", dialect->cppNamespace);
 
+  // Define specializations of OpDescription::get for reflection. They come
+  // first, since the operation definitions use them.
+  for (const auto &opPtr : dialect->operations) {
+    Operation &op = *opPtr;
+
+    FmtContextScope scope{fmt};
+    fmt.withOp(op.name);
+    fmt.addSubst("mnemonic", op.mnemonic);
+
+    std::string descArgs;
+    if (op.isIntrinsic()) {
+      descArgs = tgfmt("\"$dialect.$mnemonic\", ::llvm::Intrinsic::$0", &fmt,
+                       op.intrinsic);
+    } else {
+      descArgs = tgfmt("$0, \"$dialect.$mnemonic\"", &fmt,
+                       op.haveResultOverloadKey() ? "true" : "false");
+    }
+
+    // Call argument indices of attributes, so that generic code such as
+    // OpLowering can tell them apart from values that happen to be constant.
+    std::string attributeOperands;
+    for (auto indexedArg : llvm::enumerate(op.getFullArguments())) {
+      if (!isa<Attr>(indexedArg.value().type))
+        continue;
+      if (!attributeOperands.empty())
+        attributeOperands += ", ";
+      attributeOperands +=
+          std::to_string(op.getArgOperandIdx(indexedArg.index()));
+    }
+
+    std::string attributeOperandsDecl;
+    if (!attributeOperands.empty()) {
+      attributeOperandsDecl =
+          "static const unsigned attributeOperands[] = {" + attributeOperands +
+          "};";
+      descArgs += ", attributeOperands";
+    }
+
+    out << tgfmt(R"(
+      template <>
+      const ::llvm_dialects::OpDescription &
+      ::llvm_dialects::OpDescription::get<$namespace::$_op>() {
+        $1
+        static const ::llvm_dialects::OpDescription desc{$0};
+        return desc;
+      }
+
+    )",
+                 &fmt, descArgs, attributeOperandsDecl);
+  }
+
   if (!dialect->cppNamespace.empty())
     out << tgfmt("namespace $namespace {\n", &fmt);
 
@@ -489,16 +596,33 @@ void llvm_dialects::genDialectDefs(raw_ostream& out, RecordKeeper& records) {
       out << tgfmt(", $0 $1", &fmt, arg.type->getCppType(), argName);
     }
 
-    out << tgfmt(R"() {
+    if (op.isIntrinsic()) {
+      out << tgfmt(R"() {
+      ::llvm::LLVMContext& $_context = $_builder.getContext();
+    
+    )", &fmt);
+    } else {
+      out << tgfmt(R"() {
       ::llvm::LLVMContext& $_context = $_builder.getContext();
       ::llvm::Module& $_module = *$_builder.GetInsertBlock()->getModule();
     
     )", &fmt);
+    }
 
     // Map TableGen names of arguments to C++ expressions to be used by
     // predicates.
     DenseMap<StringRef, std::string> argToCppExprMap;
     for (const auto &[arg, argName] : llvm::zip(fullArguments, argNames)) {
+      if (auto* variadic = dyn_cast<Variadic>(arg.type)) {
+        std::string element = symbols.chooseName("element");
+        std::string elementExpr = element + "->getType()";
+        out << tgfmt("assert(::llvm::all_of($0, [&](::llvm::Value* $1) { "
+                     "return $2; }));\n",
+                     &fmt, argName, element,
+                     variadic->getElementType()->apply(&fmt, {elementExpr}));
+        continue;
+      }
+
       std::string cppExpr;
       if (isa<Attr>(arg.type))
         cppExpr = argName;
@@ -510,12 +634,14 @@ void llvm_dialects::genDialectDefs(raw_ostream& out, RecordKeeper& records) {
         out << tgfmt("assert($0);\n", &fmt, arg.type->apply(&fmt, {cppExpr}));
     }
 
-    if (op.getAttributeListIdx() < 0) {
+    if (op.isIntrinsic()) {
+      // The intrinsic declaration provides the attributes.
+    } else if (op.getAttributeListIdx() < 0) {
       out << tgfmt("const ::llvm::AttributeList $attrs;\n", &fmt);
     } else {
       out << tgfmt(R"(
         const ::llvm::AttributeList $attrs
-            = $Dialect::get($_context).getAttributeList($0);
+            = $_builder.getDialect<$Dialect>().getAttributeList($0);
       )",
                    &fmt, op.getAttributeListIdx());
     }
@@ -526,7 +652,7 @@ void llvm_dialects::genDialectDefs(raw_ostream& out, RecordKeeper& records) {
       if (isa<Attr>(arg.type)) {
         argTypes.push_back(typeBuilder.build(arg.type));
       } else {
-        if (!op.haveArgumentOverloadKey())
+        if (!op.haveArgumentOverloadKey() && !isa<Variadic>(arg.type))
           argTypes.push_back(argName + "->getType()");
         else
           argTypes.push_back("<skip type>");
@@ -554,65 +680,159 @@ void llvm_dialects::genDialectDefs(raw_ostream& out, RecordKeeper& records) {
     }
     out << '\n';
 
-    StringRef fnName;
-
-    if (op.haveResultOverloadKey()) {
-      out << tgfmt("std::string $0 = ::llvm_dialects::getMangledName(s_name, {\n", &fmt,
-                   mangledName);
-      for (const auto &key : op.overload_keys()) {
-        if (key.kind == OverloadKey::Result)
-          out << resultNames[key.index] << ",\n";
+    auto emitArgFilters = [&]() {
+      for (const auto& [name, arg] : llvm::zip_first(argNames, fullArguments)) {
+        if (auto* type = dyn_cast<Type>(arg.type)) {
+          StringRef filter = type->getBuilderArgumentFilter();
+          if (!filter.empty()) {
+            FmtContextScope scope{fmt};
+            fmt.withSelf(name);
+            out << tgfmt(filter, &fmt);
+          }
+        }
       }
-      out << "});\n";
+    };
 
-      fnName = mangledName;
+    auto emitArgValue = [&](unsigned argIdx) {
+      if (auto* attr = dyn_cast<Attr>(fullArguments[argIdx].type)) {
+        out << tgfmt(attr->getToLlvmValue(), &fmt, argNames[argIdx],
+                     argTypes[argIdx]);
+      } else {
+        out << argNames[argIdx];
+      }
+      out << ",\n";
+    };
+
+    if (op.isIntrinsic()) {
+      emitArgFilters();
+      out << tgfmt("return ::llvm_dialects::createIntrinsicCall($_builder, "
+                   "::llvm::Intrinsic::$0, $1, {\n",
+                   &fmt, op.intrinsic, resultTypeName);
+      for (unsigned argIdx : op.intrinsicArgs)
+        emitArgValue(argIdx);
+      out << "});\n}\n\n";
     } else {
-      fnName = "s_name";
-    }
+      StringRef fnName;
+
+      if (op.haveResultOverloadKey()) {
+        out << tgfmt("std::string $0 = "
+                     "$_builder.getDialectContext().getOverloadName($_module, "
+                     "s_name, $1, {\n",
+                     &fmt, mangledName, resultTypeName);
+        for (const auto &key : op.overload_keys()) {
+          if (key.kind == OverloadKey::Result)
+            out << resultNames[key.index] << ",\n";
+        }
+        out << "});\n";
 
-    if (op.haveArgumentOverloadKey()) {
-      out << tgfmt("auto $fnType = ::llvm::FunctionType::get($0, true);\n",
-                   &fmt, resultTypeName);
-    } else {
-      out << tgfmt("auto $fnType = ::llvm::FunctionType::get($0, {\n", &fmt,
-                   resultTypeName);
-      for (const auto &argType : argTypes)
-        out << argType << ",\n";
-      out << "}, false);\n";
-    }
+        fnName = mangledName;
+      } else {
+        fnName = "s_name";
+      }
 
-    out << tgfmt(
-        "\nauto $0 = $_module.getOrInsertFunction($1, $fnType, $attrs);\n\n",
-        &fmt, fn, fnName);
+      if (op.haveArgumentOverloadKey()) {
+        out << tgfmt("auto $fnType = ::llvm::FunctionType::get($0, true);\n",
+                     &fmt, resultTypeName);
+      } else {
+        out << tgfmt("auto $fnType = ::llvm::FunctionType::get($0, {\n", &fmt,
+                     resultTypeName);
+        for (const auto &[arg, argType] : llvm::zip(fullArguments, argTypes)) {
+          if (!isa<Variadic>(arg.type))
+            out << argType << ",\n";
+        }
+        out << tgfmt("}, $0);\n", &fmt,
+                     op.hasVariadicArgument() ? "true" : "false");
+      }
 
-    for (const auto& [name, arg] : llvm::zip_first(argNames, fullArguments)) {
-      if (auto* type = dyn_cast<Type>(arg.type)) {
-        StringRef filter = type->getBuilderArgumentFilter();
-        if (!filter.empty()) {
+      out << tgfmt(
+          "\nauto $0 = $_module.getOrInsertFunction($1, $fnType, $attrs);\n"
+          "$_builder.getDialectContext().noteDeclaration($0.getCallee());\n\n",
+          &fmt, fn, fnName);
+
+      emitArgFilters();
+
+      if (op.hasVariadicArgument()) {
+        // The variadic arguments are appended to the fixed ones.
+        unsigned numFixed = argNames.size() - 1;
+        auto* variadic = cast<Variadic>(fullArguments.back().type);
+        out << tgfmt("::llvm::SmallVector<::llvm::Value*> $0 = {\n", &fmt,
+                     args);
+        for (unsigned argIdx = 0; argIdx < numFixed; ++argIdx)
+          emitArgValue(argIdx);
+        out << tgfmt("};\n$0.append($1.begin(), $1.end());\n", &fmt, args,
+                     argNames.back());
+
+        StringRef filter = variadic->getElementType()->getBuilderArgumentFilter();
+        if (isa<Type>(variadic->getElementType()) && !filter.empty()) {
+          std::string element = symbols.chooseName("element");
           FmtContextScope scope{fmt};
-          fmt.withSelf(name);
+          fmt.withSelf(element);
+          out << tgfmt("for (::llvm::Value*& $0 : ::llvm::drop_begin($1, $2)) {\n",
+                       &fmt, element, args, numFixed);
           out << tgfmt(filter, &fmt);
+          out << "}\n";
         }
+        out << '\n';
+      } else if (!argNames.empty()) {
+        out << tgfmt("::llvm::Value* const $0[] = {\n", &fmt, args);
+        for (unsigned argIdx = 0; argIdx < argNames.size(); ++argIdx)
+          emitArgValue(argIdx);
+        out << "};\n\n";
       }
-    }
 
-    if (!argNames.empty()) {
-      out << tgfmt("::llvm::Value* const $0[] = {\n", &fmt, args);
-      for (const auto& [name, type, arg]
-               : llvm::zip_first(argNames, argTypes, fullArguments)) {
-        if (auto* attr = dyn_cast<Attr>(arg.type)) {
-          out << tgfmt(attr->getToLlvmValue(), &fmt, name, type);
+      if (!argNames.empty()) {
+
+        if (op.conditionalAttributes.empty()) {
+          out << tgfmt("return $_builder.CreateCall($0, $1);\n", &fmt, fn,
+                       args);
         } else {
-          out << name;
+          // Refine the attributes of the declaration at the call site.
+          std::string call = symbols.chooseName("call");
+          out << tgfmt("::llvm::CallInst* $0 = $_builder.CreateCall($1, $2);\n",
+                       &fmt, call, fn, args);
+          for (const auto &enumeratedConditional :
+               llvm::enumerate(op.conditionalAttributes)) {
+            const OpConditionalAttributes &conditional =
+                enumeratedConditional.value();
+            out << tgfmt("$0if ($1 == $2)\n  $3->setAttributes("
+                         "$_builder.getDialect<$Dialect>().getAttributeList($4));\n",
+                         &fmt,
+                         enumeratedConditional.index() != 0 ? "else " : "",
+                         argNames[conditional.argIdx], conditional.value, call,
+                         conditional.attributeListIdx);
+          }
+          out << tgfmt("return $0;\n", &fmt, call);
         }
-        out << ",\n";
+      } else
+        out << tgfmt("return $_builder.CreateCall($0);\n", &fmt, fn);
+      out << "}\n\n";
+    }
+
+    // Emit cloneWithTypes() method definition. The overload types are those
+    // that are mangled into the declaration name, i.e. the result overload
+    // keys.
+    if (op.haveResultOverloadKey() && !op.isIntrinsic()) {
+      unsigned numResultKeys = 0;
+      unsigned resultKeyIdx = 0;
+      for (const auto &key : op.overload_keys()) {
+        if (key.kind != OverloadKey::Result)
+          continue;
+        if (key.index == 0)
+          resultKeyIdx = numResultKeys;
+        ++numResultKeys;
       }
-      out << "};\n\n";
 
-      out << tgfmt("return $_builder.CreateCall($0, $1);\n", &fmt, fn, args);
-    } else
-      out << tgfmt("return $_builder.CreateCall($0);\n", &fmt, fn);
-    out << "}\n\n";
+      out << tgfmt(R"(
+        $_op* $_op::cloneWithTypes(::llvm_dialects::Builder& b,
+                                   ::llvm::ArrayRef<::llvm::Type*> overloadTypes) {
+          assert(overloadTypes.size() == $0);
+          return ::llvm::cast<$_op>(::llvm_dialects::cloneDialectOp(
+              b, *this, ::llvm_dialects::OpDescription::get<$_op>(),
+              overloadTypes[$1], overloadTypes));
+        }
+
+      )", &fmt, numResultKeys, resultKeyIdx);
+    }
 
     // Emit argument getters.
     unsigned numSuperclassArgs = 0;
@@ -620,15 +840,18 @@ void llvm_dialects::genDialectDefs(raw_ostream& out, RecordKeeper& records) {
       numSuperclassArgs = op.superclass->getNumFullArguments();
     for (auto indexedArg : llvm::enumerate(op.arguments)) {
       const OpNamedValue& arg = indexedArg.value();
-      std::string value = llvm::formatv("getArgOperand({0})",
-                                        numSuperclassArgs + indexedArg.index());
+      unsigned operandIdx =
+          op.getArgOperandIdx(numSuperclassArgs + indexedArg.index());
+      std::string value = llvm::formatv("getArgOperand({0})", operandIdx);
       if (auto* attr = dyn_cast<Attr>(arg.type))
         value = tgfmt(attr->getFromLlvmValue(), &fmt, value);
+      else if (isa<Variadic>(arg.type))
+        value = llvm::formatv("{{arg_begin() + {0}, arg_end()}", operandIdx);
       out << tgfmt(R"(
         $0 $_op::get$1() {
           return $2;
         }
-      )", &fmt, arg.type->getCppType(), convertToCamelFromSnakeCase(arg.name, true), value);
+      )", &fmt, getGetterCppType(arg.type), convertToCamelFromSnakeCase(arg.name, true), value);
     }
 
     out << '\n';
@@ -645,27 +868,399 @@ void llvm_dialects::genDialectDefs(raw_ostream& out, RecordKeeper& records) {
   if (!dialect->cppNamespace.empty())
     out << tgfmt("} // namespace $namespace\n", &fmt);
 
-  // Define specializations of OpDescription::get for reflection
+  std::string intrinsicOps;
   for (const auto &opPtr : dialect->operations) {
-    Operation &op = *opPtr;
+    if (!opPtr->isIntrinsic())
+      continue;
+    FmtContextScope scope{fmt};
+    fmt.withOp(opPtr->name);
+    intrinsicOps += tgfmt(
+        "&::llvm_dialects::OpDescription::get<$namespace::$_op>(),\n", &fmt);
+  }
+
+  out << tgfmt(R"(
+    ::llvm::ArrayRef<const ::llvm_dialects::OpDescription*>
+    $namespace::$Dialect::getIntrinsicOps() {
+  )",
+               &fmt);
+  if (intrinsicOps.empty()) {
+    out << "return {};\n";
+  } else {
+    out << "static const ::llvm_dialects::OpDescription* const ops[] = {\n"
+        << intrinsicOps << "};\nreturn ops;\n";
+  }
+  out << "}\n";
+
+  out << R"(
+#endif // GET_DIALECT_DEFS
+)";
+}
+
+void llvm_dialects::genDialectBench(raw_ostream& out, RecordKeeper& records) {
+  auto [context, dialect] = getSelectedDialect(records);
+
+  emitHeader(out);
 
+  out << R"(
+#ifdef GET_INCLUDES
+#undef GET_INCLUDES
+#include "llvm-dialects/Dialect/Builder.h"
+#include "llvm-dialects/Dialect/Visitor.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#endif // GET_INCLUDES
+
+#ifdef GET_DIALECT_BENCH
+#undef GET_DIALECT_BENCH
+)";
+
+  FmtContext fmt;
+  fmt.addSubst("Dialect", dialect->cppName);
+  fmt.addSubst("dialect", dialect->name);
+  fmt.addSubst("namespace", dialect->cppNamespace);
+  fmt.withContext("context");
+  fmt.withBuilder("b");
+
+  std::string qualifier;
+  if (!dialect->cppNamespace.empty())
+    qualifier = dialect->cppNamespace + "::";
+
+  // Helpers and setup of the module into which all operations are created.
+  out << tgfmt(R"(
+namespace {
+
+using BenchClock = ::std::chrono::steady_clock;
+
+double elapsedNs(BenchClock::time_point start, unsigned count) {
+  ::std::chrono::duration<double, ::std::nano> elapsed = BenchClock::now() - start;
+  return count ? elapsed.count() / count : 0.0;
+}
+
+/// Return the first candidate type that satisfies the given predicate, or
+/// null if there is none.
+template <typename PredT>
+::llvm::Type* pickType(::llvm::ArrayRef<::llvm::Type*> candidates, PredT pred) {
+  for (::llvm::Type* candidate : candidates) {
+    if (pred(candidate))
+      return candidate;
+  }
+  return nullptr;
+}
+
+template <typename OpT>
+unsigned countVisited(::llvm::Module& module, ::llvm_dialects::VisitorStrategy strategy,
+                      double& nsPerOp,
+                      ::llvm_dialects::DialectContext* dialectContext = nullptr) {
+  auto visitor = ::llvm_dialects::VisitorBuilder<unsigned>()
+                     .setStrategy(strategy)
+                     .template add<OpT>([](unsigned& count, OpT&) { ++count; })
+                     .build();
+  unsigned count = 0;
+  auto start = BenchClock::now();
+  if (dialectContext)
+    visitor.visit(count, module, *dialectContext);
+  else
+    visitor.visit(count, module);
+  nsPerOp = elapsedNs(start, count);
+  return count;
+}
+
+template <typename OpT>
+void reportQueries(::llvm::raw_ostream& out, ::llvm::Module& module,
+                   ::llvm::Function& fn, unsigned numInsts) {
+  unsigned matched = 0;
+  auto start = BenchClock::now();
+  for (::llvm::BasicBlock& bb : fn) {
+    for (::llvm::Instruction& inst : bb) {
+      if (::llvm::isa<OpT>(&inst))
+        ++matched;
+    }
+  }
+  double classofNs = elapsedNs(start, numInsts);
+
+  double byInstructionNs;
+  double byDeclarationNs;
+  unsigned byInstruction = countVisited<OpT>(
+      module, ::llvm_dialects::VisitorStrategy::ByInstruction, byInstructionNs);
+  unsigned byDeclaration = countVisited<OpT>(
+      module, ::llvm_dialects::VisitorStrategy::ByFunctionDeclaration,
+      byDeclarationNs);
+
+  // Build the declaration directory entry of the module before measuring, so
+  // that the steady state is measured.
+  auto& dialectContext = ::llvm_dialects::DialectContext::get(module.getContext());
+  dialectContext.enableDeclarationDirectory();
+  double byDirectoryNs;
+  countVisited<OpT>(module, ::llvm_dialects::VisitorStrategy::ByFunctionDeclaration,
+                    byDirectoryNs, &dialectContext);
+  unsigned byDirectory = countVisited<OpT>(
+      module, ::llvm_dialects::VisitorStrategy::ByFunctionDeclaration,
+      byDirectoryNs, &dialectContext);
+  dialectContext.enableDeclarationDirectory(false);
+
+  out << ", \"classof_matched\": " << matched
+      << ", \"classof_ns_per_inst\": " << ::llvm::format("%.2f", classofNs)
+      << ", \"visit_by_instruction_count\": " << byInstruction
+      << ", \"visit_by_instruction_ns_per_op\": "
+      << ::llvm::format("%.2f", byInstructionNs)
+      << ", \"visit_by_declaration_count\": " << byDeclaration
+      << ", \"visit_by_declaration_ns_per_op\": "
+      << ::llvm::format("%.2f", byDeclarationNs)
+      << ", \"visit_by_directory_count\": " << byDirectory
+      << ", \"visit_by_directory_ns_per_op\": "
+      << ::llvm::format("%.2f", byDirectoryNs);
+}
+
+/// Create each operation @p numOps times at the insert point of @p b. Stores
+/// the average creation time of each operation in @p createNs, or a negative
+/// value if no operand types could be synthesized for the operation. Returns
+/// the number of created operations.
+unsigned createOps(::llvm_dialects::Builder& b, unsigned numOps,
+                   double (&createNs)[$1]) {
+  ::llvm::LLVMContext& context = b.getContext();
+  unsigned numCreated = 0;
+
+  ::llvm::Type* const candidates[] = {
+      b.getInt32Ty(),
+      b.getInt64Ty(),
+      b.getInt1Ty(),
+      b.getFloatTy(),
+      ::llvm::PointerType::get(context, 0),
+      ::llvm::FixedVectorType::get(b.getInt32Ty(), 4),
+)", &fmt, qualifier, dialect->operations.size());
+
+  for (DialectType *type : dialect->types)
+    out << tgfmt("      $0$1::get(b),\n", &fmt, qualifier, type->getName());
+
+  out << R"(  };
+  (void)candidates;
+  (void)context;
+)";
+
+  // Phase 1: create each operation in bulk.
+  for (const auto& enumeratedOp : llvm::enumerate(dialect->operations)) {
+    const Operation& op = *enumeratedOp.value();
+    unsigned opIdx = enumeratedOp.index();
     FmtContextScope scope{fmt};
-    fmt.withOp(op.name);
-    fmt.addSubst("mnemonic", op.mnemonic);
+    fmt.withOp(qualifier + op.name);
 
-    out << tgfmt(R"(
-      template <>
-      const ::llvm_dialects::OpDescription &
-      ::llvm_dialects::OpDescription::get<$namespace::$_op>() {
-        static const ::llvm_dialects::OpDescription desc{$0, "$dialect.$mnemonic"};
-        return desc;
+    out << tgfmt("\n  // $_op\n  createNs[$0] = -1.0;\n  {\n", &fmt,
+                 opIdx);
+
+    SmallVector<std::string> createArgs;
+    SmallVector<std::string> typeVars;
+
+    auto emitPickedType = [&](const Constraint *constraint) {
+      std::string var = llvm::formatv("type{0}", typeVars.size()).str();
+      typeVars.push_back(var);
+      if (auto *type = dyn_cast<Type>(constraint)) {
+        out << tgfmt("    ::llvm::Type* $0 = $1;\n", &fmt, var,
+                     type->getLlvmType(&fmt));
+      } else {
+        out << tgfmt("    ::llvm::Type* $0 = pickType(candidates, "
+                     "[&](::llvm::Type* self) -> bool { return $1; });\n",
+                     &fmt, var, constraint->apply(&fmt, {"self"}));
       }
+      return var;
+    };
 
-    )",
-                 &fmt, op.haveResultOverloadKey() ? "true" : "false");
+    if (op.builderHasExplicitResultTypes) {
+      for (const auto& result : op.results)
+        createArgs.push_back(emitPickedType(result.type));
+    }
+
+    for (const auto& arg : op.getFullArguments()) {
+      if (auto *attr = dyn_cast<Attr>(arg.type)) {
+        createArgs.push_back(tgfmt("$0{}", &fmt, attr->getCppType()));
+        continue;
+      }
+      // Variadic arguments are passed a single element.
+      auto *variadic = dyn_cast<Variadic>(arg.type);
+      std::string typeVar =
+          emitPickedType(variadic ? variadic->getElementType() : arg.type);
+      std::string valueVar = "value" + typeVar.substr(4);
+      out << tgfmt("    ::llvm::Value* $0 = $1 ? ::llvm::UndefValue::get($1) "
+                   ": nullptr;\n",
+                   &fmt, valueVar, typeVar);
+      if (variadic)
+        createArgs.push_back("::llvm::ArrayRef<::llvm::Value*>(" + valueVar + ")");
+      else
+        createArgs.push_back(valueVar);
+    }
+
+    if (!typeVars.empty()) {
+      out << "    if (";
+      for (const auto& enumeratedVar : llvm::enumerate(typeVars)) {
+        if (enumeratedVar.index() != 0)
+          out << " && ";
+        out << enumeratedVar.value();
+      }
+      out << ") {\n";
+    } else {
+      out << "    {\n";
+    }
+
+    out << tgfmt(R"(      auto start = BenchClock::now();
+      for (unsigned i = 0; i < numOps; ++i)
+        $_op::create(b)", &fmt);
+    for (const auto& arg : createArgs)
+      out << ", " << arg;
+    out << tgfmt(R"();
+      createNs[$0] = elapsedNs(start, numOps);
+      numCreated += numOps;
+    }
+  }
+)", &fmt, opIdx);
+  }
+
+  out << tgfmt(R"(
+  return numCreated;
+}
+
+/// Run @p createOps in @p numThreads threads at once, each with its own
+/// contexts and module. Returns the average time per created operation.
+///
+/// The threads share no IR, so any slowdown compared to a single thread is due
+/// to state that is shared between dialect contexts (or to the machine).
+double createOpsThreaded(unsigned numThreads, unsigned numOps) {
+  ::std::atomic<unsigned> numReady{0};
+  ::std::atomic<bool> go{false};
+  ::std::vector<double> nsPerOp(numThreads);
+  ::std::vector<::std::thread> threads;
+  for (unsigned threadIdx = 0; threadIdx < numThreads; ++threadIdx) {
+    threads.emplace_back([&, threadIdx]() {
+      ::llvm::LLVMContext context;
+      auto dialectContext =
+          ::llvm_dialects::DialectContext::make<$0$Dialect>(context);
+      ::llvm::Module module("bench.thread", context);
+      ::llvm_dialects::Builder b{*dialectContext};
+      ::llvm::Function* fn = ::llvm::Function::Create(
+          ::llvm::FunctionType::get(b.getVoidTy(), false),
+          ::llvm::GlobalValue::ExternalLinkage, "bench", module);
+      b.SetInsertPoint(::llvm::BasicBlock::Create(context, "entry", fn));
+
+      ++numReady;
+      while (!go)
+        ::std::this_thread::yield();
+
+      double createNs[$1];
+      auto start = BenchClock::now();
+      unsigned numCreated = createOps(b, numOps, createNs);
+      nsPerOp[threadIdx] = elapsedNs(start, numCreated);
+    });
+  }
+  while (numReady != numThreads)
+    ::std::this_thread::yield();
+  go = true;
+
+  double sum = 0.0;
+  for (unsigned threadIdx = 0; threadIdx < numThreads; ++threadIdx) {
+    threads[threadIdx].join();
+    sum += nsPerOp[threadIdx];
+  }
+  return sum / numThreads;
+}
+
+} // anonymous namespace
+
+/// Benchmark the operations of the $dialect dialect.
+///
+/// Usage: <program> [number of ops created per operation
+///                   [number of unrelated declarations [number of threads]]]
+///
+/// Unrelated declarations are added to the module before the operations, as
+/// found e.g. in long-running JIT modules.
+///
+/// If a number of threads is given, the operations are additionally created
+/// concurrently in that many independent contexts, and the cost per operation
+/// is compared against the same loop in a single thread.
+///
+/// Operand and result types of overloaded operations are synthesized by
+/// picking the first type from a fixed list of candidates that satisfies the
+/// argument's constraint. Verifier rules that relate different arguments are
+/// not taken into account.
+int main(int argc, char** argv) {
+  unsigned numOps = argc > 1 ? ::std::atoi(argv[1]) : 10000;
+  unsigned numUnrelatedDecls = argc > 2 ? ::std::atoi(argv[2]) : 0;
+  unsigned numThreads = argc > 3 ? ::std::atoi(argv[3]) : 0;
+
+  ::llvm::LLVMContext context;
+  auto dialectContext = ::llvm_dialects::DialectContext::make<$0$Dialect>(context);
+  ::llvm::Module module("bench", context);
+  for (unsigned i = 0; i < numUnrelatedDecls; ++i) {
+    ::llvm::Function::Create(::llvm::FunctionType::get(::llvm::Type::getVoidTy(context), false),
+                             ::llvm::GlobalValue::ExternalLinkage,
+                             "unrelated." + ::llvm::Twine(i), module);
   }
+  ::llvm_dialects::Builder b{*dialectContext};
+
+  ::llvm::Function* fn = ::llvm::Function::Create(
+      ::llvm::FunctionType::get(b.getVoidTy(), false),
+      ::llvm::GlobalValue::ExternalLinkage, "bench", module);
+  b.SetInsertPoint(::llvm::BasicBlock::Create(context, "entry", fn));
+
+  double createNs[$1];
+  createOps(b, numOps, createNs);
+  b.CreateRetVoid();
+
+  ::llvm::raw_ostream& out = ::llvm::outs();
+)", &fmt, qualifier, dialect->operations.size());
 
   out << R"(
-#endif // GET_DIALECT_DEFS
+  unsigned numInsts = fn->getInstructionCount();
+
+  out << "{\n  \"dialect\": \")" << dialect->name << R"(\",\n"
+      << "  \"num_ops\": " << numOps << ",\n"
+      << "  \"num_insts\": " << numInsts << ",\n"
+      << "  \"ops\": [";
+)";
+
+  // Phase 2: report creation cost and query costs.
+  for (const auto& enumeratedOp : llvm::enumerate(dialect->operations)) {
+    const Operation& op = *enumeratedOp.value();
+    FmtContextScope scope{fmt};
+    fmt.withOp(qualifier + op.name);
+    fmt.addSubst("mnemonic", op.mnemonic);
+
+    out << tgfmt(R"(
+  out << "$0\n    {\"name\": \"$dialect.$mnemonic\"";
+  if (createNs[$1] < 0.0) {
+    out << ", \"skipped\": true";
+  } else {
+    out << ", \"create_ns_per_op\": " << ::llvm::format("%.2f", createNs[$1]);
+    reportQueries<$_op>(out, module, *fn, numInsts);
+  }
+  out << "}";
+)", &fmt, enumeratedOp.index() != 0 ? "," : "", enumeratedOp.index());
+  }
+
+  out << R"(
+  out << "\n  ]";
+
+  // Phase 3: concurrent creation in independent contexts.
+  if (numThreads) {
+    double singleNs = createOpsThreaded(1, numOps);
+    double threadedNs = createOpsThreaded(numThreads, numOps);
+    out << ",\n  \"threaded\": {\"threads\": " << numThreads
+        << ", \"single_thread_create_ns_per_op\": "
+        << ::llvm::format("%.2f", singleNs)
+        << ", \"create_ns_per_op\": " << ::llvm::format("%.2f", threadedNs)
+        << ", \"slowdown\": "
+        << ::llvm::format("%.2f", singleNs > 0.0 ? threadedNs / singleNs : 0.0)
+        << "}";
+  }
+  out << "\n}\n";
+  return 0;
+}
+
+#endif // GET_DIALECT_BENCH
 )";
 }
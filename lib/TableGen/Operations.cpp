@@ -16,6 +16,10 @@
 
 #include "llvm-dialects/TableGen/Operations.h"
 
+#include "llvm-dialects/TableGen/Constraints.h"
+
+#include "llvm/Support/Casting.h"
+
 using namespace llvm;
 using namespace llvm_dialects;
 
@@ -46,3 +50,15 @@ unsigned Operation::getNumFullArguments() const {
     return superclass->getNumFullArguments() + arguments.size();
   return arguments.size();
 }
+
+unsigned Operation::getArgOperandIdx(unsigned argIdx) const {
+  if (!isIntrinsic())
+    return argIdx;
+  auto it = llvm::find(intrinsicArgs, argIdx);
+  assert(it != intrinsicArgs.end());
+  return std::distance(intrinsicArgs.begin(), it);
+}
+
+bool Operation::hasVariadicArgument() const {
+  return !arguments.empty() && isa<Variadic>(arguments.back().type);
+}
@@ -26,14 +26,111 @@
 #include "ExampleDialect.h"
 
 #include "llvm-dialects/Dialect/Builder.h"
+#include "llvm-dialects/Dialect/DialectUsage.h"
+#include "llvm-dialects/Dialect/OpCountInstrumentation.h"
+#include "llvm-dialects/Dialect/OpDescription.h"
+#include "llvm-dialects/Dialect/OpLowering.h"
+#include "llvm-dialects/Dialect/PureOpInliner.h"
+#include "llvm-dialects/Dialect/Utils.h"
+#include "llvm-dialects/Dialect/Visitor.h"
 
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Verifier.h"
 #include "llvm/IRPrinter/IRPrintingPasses.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include <chrono>
+#include <optional>
+#include <random>
 
 using namespace llvm;
 using namespace llvm_dialects;
 
+static cl::opt<bool> g_instrumentOpCounts(
+    "instrument-op-counts",
+    cl::desc("instrument the module to count dialect op executions"));
+
+static cl::opt<bool> g_dialectUsage(
+    "dialect-usage",
+    cl::desc("attach dialect usage summaries to all functions"));
+
+static cl::opt<bool> g_widenCombine(
+    "widen-combine",
+    cl::desc("rewrite i32 combine ops to i64 using cloneWithTypes"));
+
+static cl::opt<bool> g_inlinePureHelpers(
+    "inline-pure-helpers",
+    cl::desc("add small helper functions and inline those that only contain "
+             "pure dialect ops"));
+
+static cl::opt<bool> g_intrinsicOps(
+    "intrinsic-ops",
+    cl::desc("add a function that uses intrinsic-backed ops and visit them"));
+
+static cl::opt<bool> g_variadic(
+    "variadic",
+    cl::desc("add a function that uses ops with variadic arguments and visit "
+             "them"));
+
+static cl::opt<bool> g_exchange(
+    "exchange",
+    cl::desc("add a function that uses ops with attribute-dependent memory "
+             "effects"));
+
+static cl::opt<bool> g_compactOverloadNames(
+    "compact-overload-names",
+    cl::desc("use compact declaration names for overloaded ops, and add a "
+             "function that uses an overload with a long name"));
+
+static cl::opt<bool> g_declarationDirectory(
+    "declaration-directory",
+    cl::desc("let visitors find declarations via the declaration directory"));
+
+static cl::opt<bool> g_declarationChurn(
+    "declaration-churn",
+    cl::desc("delete a declaration and create another one between two visits"));
+
+static cl::opt<bool> g_lower(
+    "lower", cl::desc("lower the example dialect to core LLVM IR and add a "
+                      "main function, so that the result can be run by lli"));
+
+static cl::opt<bool> g_lowerOutlined(
+    "lower-outlined",
+    cl::desc("like --lower, but emit each distinct op lowering once into a "
+             "shared helper function"));
+
+static cl::opt<bool> g_workload(
+    "workload",
+    cl::desc("instead of printing the example module, generate a module and "
+             "run it through a build, visit, lower, verify and bitcode "
+             "round-trip pipeline, printing per-phase timings as JSON"));
+
+static cl::opt<unsigned>
+    g_workloadFunctions("workload-functions", cl::init(100),
+                        cl::desc("number of functions in the workload"));
+
+static cl::opt<unsigned>
+    g_workloadOps("workload-ops", cl::init(100),
+                  cl::desc("number of dialect ops per workload function"));
+
+static cl::opt<std::string> g_workloadMix(
+    "workload-mix",
+    cl::init("read=1,write=1,add32=2,combine=2,sum=1,exchange=1,umin=1,ctlz=1"),
+    cl::desc("relative frequencies of the workload ops, as comma-separated "
+             "op=weight pairs"));
+
+static cl::opt<unsigned>
+    g_workloadSeed("workload-seed", cl::init(1),
+                   cl::desc("seed for the random choices of the workload"));
+
 void createFunctionExample(Module &module, const Twine &name) {
   Builder b{module.getContext()};
 
@@ -56,12 +153,684 @@ std::unique_ptr<Module> createModuleExample(LLVMContext &context) {
   return module;
 }
 
+/// Create a main function that runs the example function a few times.
+void createMainExample(Module &module) {
+  Builder b{module.getContext()};
+
+  Function *example = module.getFunction("example");
+  Function *fn = Function::Create(FunctionType::get(b.getInt32Ty(), false),
+                                  GlobalValue::ExternalLinkage, "main", module);
+
+  BasicBlock *bb = BasicBlock::Create(module.getContext(), "entry", fn);
+  b.SetInsertPoint(bb);
+
+  for (unsigned i = 0; i < 3; ++i)
+    b.CreateCall(example);
+  b.CreateRet(b.getInt32(0));
+}
+
+/// Create helper functions of the kind that frontends tend to emit, and a
+/// function that calls them. Only the first helper contains nothing but pure
+/// dialect operations.
+void createHelperExample(Module &module) {
+  Builder b{module.getContext()};
+  Type *i32 = b.getInt32Ty();
+
+  Function *pure = Function::Create(FunctionType::get(i32, {i32, i32}, false),
+                                    GlobalValue::InternalLinkage,
+                                    "example.pure_helper", module);
+  b.SetInsertPoint(BasicBlock::Create(module.getContext(), "entry", pure));
+  Value *sum = b.create<xd::Add32Op>(pure->getArg(0), pure->getArg(1), 3);
+  b.CreateRet(b.create<xd::CombineOp>(i32, sum, pure->getArg(0)));
+
+  Function *impure = Function::Create(FunctionType::get(i32, {i32}, false),
+                                      GlobalValue::InternalLinkage,
+                                      "example.impure_helper", module);
+  b.SetInsertPoint(BasicBlock::Create(module.getContext(), "entry", impure));
+  Value *data = b.create<xd::ReadOp>(i32);
+  b.CreateRet(b.create<xd::Add32Op>(data, impure->getArg(0), 0));
+
+  Function *user = Function::Create(FunctionType::get(i32, {i32}, false),
+                                    GlobalValue::ExternalLinkage,
+                                    "example.helper_user", module);
+  b.SetInsertPoint(BasicBlock::Create(module.getContext(), "entry", user));
+  Value *x1 = b.CreateCall(pure, {user->getArg(0), b.getInt32(1)});
+  Value *x2 = b.CreateCall(impure, {x1});
+  b.CreateRet(b.CreateCall(pure, {x2, x1}));
+
+  Function *noinlineUser = Function::Create(
+      FunctionType::get(i32, {i32}, false), GlobalValue::ExternalLinkage,
+      "example.noinline_user", module);
+  b.SetInsertPoint(
+      BasicBlock::Create(module.getContext(), "entry", noinlineUser));
+  CallInst *call = b.CreateCall(pure, {noinlineUser->getArg(0), b.getInt32(2)});
+  call->setIsNoInline();
+  b.CreateRet(call);
+}
+
+/// Create a function that uses operations which are represented as calls of
+/// LLVM intrinsics.
+void createIntrinsicExample(Module &module) {
+  Builder b{module.getContext()};
+  Type *i32 = b.getInt32Ty();
+
+  Function *fn = Function::Create(FunctionType::get(i32, {i32}, false),
+                                  GlobalValue::ExternalLinkage,
+                                  "example.intrinsics", module);
+  b.SetInsertPoint(BasicBlock::Create(module.getContext(), "entry", fn));
+  Value *x1 = b.create<xd::UMinOp>(fn->getArg(0), b.getInt32(7));
+  Value *x2 = b.create<xd::UMinOp>(x1, fn->getArg(0));
+  b.CreateRet(b.create<xd::CountLeadingZerosOp>(false, x2));
+
+  // A wider overload of the intrinsic, which is not an xd.umin.
+  Type *i64 = b.getInt64Ty();
+  Function *wide = Function::Create(FunctionType::get(i64, {i64}, false),
+                                    GlobalValue::ExternalLinkage,
+                                    "example.intrinsics.i64", module);
+  b.SetInsertPoint(BasicBlock::Create(module.getContext(), "entry", wide));
+  b.CreateRet(b.CreateBinaryIntrinsic(Intrinsic::umin, wide->getArg(0),
+                                      b.getInt64(7)));
+}
+
+/// Create a function that uses an operation with a variadic argument.
+void createVariadicExample(Module &module) {
+  Builder b{module.getContext()};
+  Type *i32 = b.getInt32Ty();
+
+  Function *fn = Function::Create(FunctionType::get(i32, {i32, i32}, false),
+                                  GlobalValue::ExternalLinkage,
+                                  "example.variadic", module);
+  b.SetInsertPoint(BasicBlock::Create(module.getContext(), "entry", fn));
+  Value *x1 = b.create<xd::SumOp>(1, ArrayRef<Value *>());
+  Value *values[] = {fn->getArg(0), fn->getArg(1), x1};
+  b.CreateRet(b.create<xd::SumOp>(0, values));
+}
+
+/// Create a function that uses overloads whose mangled names are long.
+void createCompactExample(Module &module) {
+  Builder b{module.getContext()};
+  Type *data = StructType::get(
+      b.getInt32Ty(), b.getInt64Ty(), FixedVectorType::get(b.getFloatTy(), 4));
+
+  Function *fn = Function::Create(FunctionType::get(b.getVoidTy(), false),
+                                  GlobalValue::ExternalLinkage,
+                                  "example.compact", module);
+  b.SetInsertPoint(BasicBlock::Create(module.getContext(), "entry", fn));
+  Value *x1 = b.create<xd::ReadOp>(data);
+  Value *x2 = b.create<xd::CombineOp>(data, x1, x1);
+  b.create<xd::WriteOp>(x2);
+  b.CreateRetVoid();
+
+  // Take the compact name of an overload with a function of a different result
+  // type, as if the hashes of two overloads collided. The overload then falls
+  // back to its full name, both when created and when cloned.
+  Type *swapped = StructType::get(
+      b.getInt64Ty(), b.getInt32Ty(), FixedVectorType::get(b.getFloatTy(), 4));
+  module.getOrInsertFunction(getCompactMangledName("xd.read", swapped), data);
+
+  // Overloads that are cloned after the naming mode changed use the new mode.
+  Type *wide = StructType::get(
+      b.getInt64Ty(), b.getInt64Ty(), FixedVectorType::get(b.getFloatTy(), 4));
+
+  fn = Function::Create(FunctionType::get(b.getVoidTy(), false),
+                        GlobalValue::ExternalLinkage, "example.compact.naming",
+                        module);
+  b.SetInsertPoint(BasicBlock::Create(module.getContext(), "entry", fn));
+  b.create<xd::WriteOp>(b.create<xd::ReadOp>(swapped));
+  auto *read = cast<xd::ReadOp>(b.create<xd::ReadOp>(data));
+  b.create<xd::WriteOp>(read->cloneWithTypes(b, {swapped}));
+  b.create<xd::WriteOp>(read->cloneWithTypes(b, {wide}));
+  b.getDialectContext().setCompactOverloadNames(false);
+  b.create<xd::WriteOp>(read->cloneWithTypes(b, {wide}));
+  b.getDialectContext().setCompactOverloadNames(true);
+  b.CreateRetVoid();
+}
+
+/// Print the overloaded operations found by a visitor as IR comments.
+void visitCompactExample(Module &module, DialectContext &dialectContext) {
+  static const auto visitor =
+      VisitorBuilder<raw_ostream>()
+          .add<xd::ReadOp>([](raw_ostream &out, xd::ReadOp &op) {
+            out << "; visited xd.read: " << *op.getType() << '\n';
+          })
+          .add<xd::CombineOp>([](raw_ostream &out, xd::CombineOp &op) {
+            out << "; visited xd.combine: " << *op.getType() << '\n';
+          })
+          .build();
+  visitor.visit(llvm::outs(), module, dialectContext);
+}
+
+/// Print the variadic arguments found by a visitor as IR comments.
+void visitVariadicExample(Module &module, DialectContext &dialectContext) {
+  static const auto visitor =
+      VisitorBuilder<raw_ostream>()
+          .setStrategy(VisitorStrategy::ByFunctionDeclaration)
+          .add<xd::SumOp>([](raw_ostream &out, xd::SumOp &op) {
+            out << "; visited xd.sum: init = " << op.getInit() << ", values =";
+            for (Value *value : op.getValues()) {
+              out << ' ';
+              value->printAsOperand(out, false);
+            }
+            out << '\n';
+          })
+          .build();
+  visitor.visit(llvm::outs(), module, dialectContext);
+}
+
+/// Create a function that uses an operation whose memory effects depend on an
+/// attribute.
+void createExchangeExample(Module &module) {
+  Builder b{module.getContext()};
+  Type *i32 = b.getInt32Ty();
+
+  Function *fn = Function::Create(FunctionType::get(i32, {i32}, false),
+                                  GlobalValue::ExternalLinkage,
+                                  "example.exchange", module);
+  b.SetInsertPoint(BasicBlock::Create(module.getContext(), "entry", fn));
+  Value *x1 = b.create<xd::ExchangeOp>(false, fn->getArg(0));
+  Value *x2 = b.create<xd::ExchangeOp>(false, fn->getArg(0));
+  Value *x3 = b.create<xd::ExchangeOp>(true, b.CreateAdd(x1, x2));
+  Value *x4 = b.create<xd::ExchangeOp>(true, x3);
+  b.CreateRet(x4);
+}
+
+/// Print the intrinsic-backed operations found by a visitor as IR comments.
+void visitIntrinsicExample(Module &module, DialectContext &dialectContext) {
+  static const auto visitor =
+      VisitorBuilder<raw_ostream>()
+          .setStrategy(VisitorStrategy::ByFunctionDeclaration)
+          .add<xd::UMinOp>([](raw_ostream &out, xd::UMinOp &op) {
+            out << "; visited xd.umin: rhs = ";
+            op.getRhs()->printAsOperand(out, false);
+            out << '\n';
+          })
+          .add<xd::CountLeadingZerosOp>(
+              [](raw_ostream &out, xd::CountLeadingZerosOp &op) {
+                out << "; visited xd.ctlz: zero_is_poison = "
+                    << op.getZeroIsPoison() << '\n';
+              })
+          .build();
+  visitor.visit(llvm::outs(), module, dialectContext);
+}
+
+/// Print the number of lowered operations that a visitor still finds after
+/// lowering as an IR comment. Helpers created by an outlined lowering must not
+/// be mistaken for the operations they replace.
+void visitLoweredExample(Module &module, DialectContext &dialectContext) {
+  static const auto visitor =
+      VisitorBuilder<unsigned>()
+          .add<xd::ReadOp>([](unsigned &count, xd::ReadOp &) { ++count; })
+          .add<xd::WriteOp>([](unsigned &count, xd::WriteOp &) { ++count; })
+          .add<xd::Add32Op>([](unsigned &count, xd::Add32Op &) { ++count; })
+          .add<xd::CombineOp>([](unsigned &count, xd::CombineOp &) { ++count; })
+          .add<xd::UMinOp>([](unsigned &count, xd::UMinOp &) { ++count; })
+          .build();
+  unsigned count = 0;
+  visitor.visit(count, module, dialectContext);
+  llvm::outs() << "; remaining lowered operations: " << count << '\n';
+}
+
+/// Visit the combine and umin operations, then delete an unused declaration and
+/// create a combine of a new overload, so that the number of symbols in the
+/// module is unchanged, and visit again. The second visit must find the new
+/// overload. Do the same with a umin that is created by IRBuilder instead of
+/// the dialect builder, and with a module that replaces a destroyed one at the
+/// same address.
+void declarationChurnExample(Module &module, DialectContext &dialectContext) {
+  static const auto visitor =
+      VisitorBuilder<raw_ostream>()
+          .setStrategy(VisitorStrategy::ByFunctionDeclaration)
+          .add<xd::CombineOp>([](raw_ostream &out, xd::CombineOp &op) {
+            out << "; visited xd.combine: " << *op.getType() << '\n';
+          })
+          .add<xd::UMinOp>([](raw_ostream &out, xd::UMinOp &op) {
+            out << "; visited xd.umin\n";
+          })
+          .build();
+
+  Builder b{dialectContext};
+  Type *i64 = b.getInt64Ty();
+  Function *fn = Function::Create(FunctionType::get(i64, {i64}, false),
+                                  GlobalValue::ExternalLinkage,
+                                  "example.churn", module);
+  b.SetInsertPoint(BasicBlock::Create(module.getContext(), "entry", fn));
+  ReturnInst *ret = b.CreateRet(fn->getArg(0));
+
+  // Leave unused declarations behind.
+  SmallVector<Function *, 2> unusedDecls;
+  for (Type *type : {b.getInt16Ty(), b.getInt8Ty()}) {
+    auto *unused = cast<CallInst>(b.create<xd::ReadOp>(type));
+    unusedDecls.push_back(unused->getCalledFunction());
+    unused->eraseFromParent();
+  }
+
+  llvm::outs() << "; first visit\n";
+  visitor.visit(llvm::outs(), module, dialectContext);
+
+  unusedDecls[0]->eraseFromParent();
+  b.SetInsertPoint(ret);
+  ret->setOperand(0, b.create<xd::CombineOp>(i64, fn->getArg(0), fn->getArg(0)));
+
+  llvm::outs() << "; second visit\n";
+  visitor.visit(llvm::outs(), module, dialectContext);
+
+  unusedDecls[1]->eraseFromParent();
+  Value *narrow = b.CreateTrunc(ret->getOperand(0), b.getInt32Ty());
+  Value *min = b.CreateBinaryIntrinsic(Intrinsic::umin, narrow, b.getInt32(1));
+  ret->setOperand(0, b.CreateZExt(min, i64));
+
+  llvm::outs() << "; third visit\n";
+  visitor.visit(llvm::outs(), module, dialectContext);
+
+  // The second scratch module is constructed in the storage of the first one,
+  // whose directory entry is not invalidated.
+  std::optional<Module> scratch;
+  for (unsigned i = 0; i < 2; ++i) {
+    scratch.emplace("example.scratch", module.getContext());
+    Type *i32 = b.getInt32Ty();
+    Function *scratchFn = Function::Create(FunctionType::get(i32, {i32}, false),
+                                           GlobalValue::ExternalLinkage,
+                                           "example.scratch", *scratch);
+    b.SetInsertPoint(
+        BasicBlock::Create(module.getContext(), "entry", scratchFn));
+    b.CreateRet(b.CreateBinaryIntrinsic(Intrinsic::umin, scratchFn->getArg(0),
+                                        b.getInt32(1)));
+
+    llvm::outs() << "; scratch module visit\n";
+    visitor.visit(llvm::outs(), *scratch, dialectContext);
+  }
+}
+
+/// Widen all i32 combine operations to i64.
+void widenCombineExample(Module &module) {
+  Builder b{module.getContext()};
+
+  for (Function &fn : module.functions()) {
+    for (Instruction &inst : llvm::make_early_inc_range(instructions(fn))) {
+      auto *op = dyn_cast<xd::CombineOp>(&inst);
+      if (!op || !op->getType()->isIntegerTy(32))
+        continue;
+
+      // Tag the op, so that the output shows that the clone keeps metadata.
+      LLVMContext &context = module.getContext();
+      op->setMetadata("example.tag",
+                      MDNode::get(context, MDString::get(context, "widened")));
+
+      b.SetInsertPoint(op);
+      Value *lhs = b.CreateZExt(op->getLhs(), b.getInt64Ty());
+      Value *rhs = b.CreateZExt(op->getRhs(), b.getInt64Ty());
+      xd::CombineOp *wide = op->cloneWithTypes(b, {b.getInt64Ty()});
+      wide->setArgOperand(0, lhs);
+      wide->setArgOperand(1, rhs);
+      op->replaceAllUsesWith(b.CreateTrunc(wide, b.getInt32Ty()));
+      op->eraseFromParent();
+    }
+  }
+}
+
+/// Lower all example dialect operations to core LLVM IR. Data is read from and
+/// written to a single i32 global variable. Returns the number of lowered
+/// operations.
+unsigned lowerModuleExample(Module &module, LoweringMode mode) {
+  Type *i32 = Type::getInt32Ty(module.getContext());
+  auto *storage = new GlobalVariable(module, i32, false,
+                                     GlobalValue::InternalLinkage,
+                                     ConstantInt::get(i32, 0), "example.data");
+
+  OpLowering lowering{mode};
+  lowering.add<xd::ReadOp>([storage](Builder &b, xd::ReadOp &op) -> Value * {
+    assert(op.getType() == storage->getValueType());
+    return b.CreateLoad(op.getType(), storage);
+  });
+  lowering.add<xd::WriteOp>([storage](Builder &b, xd::WriteOp &op) -> Value * {
+    b.CreateStore(op.getData(), storage);
+    return nullptr;
+  });
+  lowering.add<xd::Add32Op>([](Builder &b, xd::Add32Op &op) -> Value * {
+    return b.CreateAdd(b.CreateAdd(op.getLhs(), op.getRhs()),
+                       b.getInt32(op.getExtra()));
+  });
+  lowering.add<xd::CombineOp>([](Builder &b, xd::CombineOp &op) -> Value * {
+    return b.CreateXor(op.getLhs(), op.getRhs());
+  });
+  lowering.add<xd::SumOp>([](Builder &b, xd::SumOp &op) -> Value * {
+    Value *sum = b.getInt32(op.getInit());
+    for (Value *value : op.getValues())
+      sum = b.CreateAdd(sum, value);
+    return sum;
+  });
+  lowering.add<xd::UMinOp>([](Builder &b, xd::UMinOp &op) -> Value * {
+    return b.CreateSelect(b.CreateICmpULT(op.getLhs(), op.getRhs()),
+                          op.getLhs(), op.getRhs());
+  });
+  lowering.add<xd::ExchangeOp>(
+      [storage](Builder &b, xd::ExchangeOp &op) -> Value * {
+        Value *old = b.CreateLoad(op.getType(), storage);
+        if (op.getIsWrite())
+          b.CreateStore(op.getData(), storage);
+        return old;
+      });
+  return lowering.run(module);
+}
+
+namespace {
+
+/// The operations that the workload can create, see --workload-mix.
+enum class WorkloadOp {
+  Read,
+  Write,
+  Add32,
+  Combine,
+  Sum,
+  Exchange,
+  UMin,
+  Ctlz,
+};
+
+const std::pair<StringRef, WorkloadOp> s_workloadOps[] = {
+    {"read", WorkloadOp::Read},         {"write", WorkloadOp::Write},
+    {"add32", WorkloadOp::Add32},       {"combine", WorkloadOp::Combine},
+    {"sum", WorkloadOp::Sum},           {"exchange", WorkloadOp::Exchange},
+    {"umin", WorkloadOp::UMin},         {"ctlz", WorkloadOp::Ctlz},
+};
+
+/// Parse the --workload-mix option into cumulative weights.
+bool parseWorkloadMix(StringRef mix,
+                      SmallVectorImpl<std::pair<unsigned, WorkloadOp>> &ops) {
+  SmallVector<StringRef> entries;
+  mix.split(entries, ',', -1, false);
+  unsigned total = 0;
+  for (StringRef entry : entries) {
+    auto [name, weightStr] = entry.split('=');
+    auto it = llvm::find_if(s_workloadOps, [name = name.trim()](const auto &op) {
+      return op.first == name;
+    });
+    unsigned weight;
+    if (it == std::end(s_workloadOps) || weightStr.trim().getAsInteger(10, weight)) {
+      errs() << "bad --workload-mix entry: '" << entry << "'\n";
+      return false;
+    }
+    if (weight == 0)
+      continue;
+    total += weight;
+    ops.emplace_back(total, it->second);
+  }
+  if (ops.empty()) {
+    errs() << "--workload-mix selects no ops\n";
+    return false;
+  }
+  return true;
+}
+
+/// Create the workload functions. Each function takes and returns an i32, and
+/// its ops use randomly chosen earlier values as operands. Returns the number
+/// of created ops.
+unsigned createWorkload(Module &module,
+                        ArrayRef<std::pair<unsigned, WorkloadOp>> mix) {
+  Builder b{module.getContext()};
+  Type *i32 = b.getInt32Ty();
+  std::mt19937 rng(g_workloadSeed);
+  unsigned numOps = 0;
+
+  for (unsigned fnIdx = 0; fnIdx < g_workloadFunctions; ++fnIdx) {
+    Function *fn = Function::Create(FunctionType::get(i32, {i32}, false),
+                                    GlobalValue::ExternalLinkage,
+                                    "workload." + Twine(fnIdx), module);
+    b.SetInsertPoint(BasicBlock::Create(module.getContext(), "entry", fn));
+
+    SmallVector<Value *> values{fn->getArg(0)};
+    auto pick = [&]() -> Value * {
+      // Prefer recent values to keep live ranges realistic.
+      unsigned window = std::min<size_t>(values.size(), 16);
+      return values[values.size() - 1 - rng() % window];
+    };
+
+    for (unsigned i = 0; i < g_workloadOps; ++i, ++numOps) {
+      unsigned choice = rng() % mix.back().first;
+      WorkloadOp op = llvm::find_if(mix, [choice](const auto &entry) {
+                        return choice < entry.first;
+                      })->second;
+
+      // Random choices are drawn into locals first, since the evaluation order
+      // of call arguments differs between compilers.
+      Value *result = nullptr;
+      switch (op) {
+      case WorkloadOp::Read:
+        result = b.create<xd::ReadOp>(i32);
+        break;
+      case WorkloadOp::Write:
+        b.create<xd::WriteOp>(pick());
+        break;
+      case WorkloadOp::Add32: {
+        Value *lhs = pick();
+        Value *rhs = pick();
+        unsigned extra = rng() % 16;
+        result = b.create<xd::Add32Op>(lhs, rhs, extra);
+        break;
+      }
+      case WorkloadOp::Combine: {
+        Value *lhs = pick();
+        Value *rhs = pick();
+        result = b.create<xd::CombineOp>(i32, lhs, rhs);
+        break;
+      }
+      case WorkloadOp::Sum: {
+        SmallVector<Value *, 3> summands;
+        for (unsigned j = rng() % 4; j; --j)
+          summands.push_back(pick());
+        unsigned init = rng() % 16;
+        result = b.create<xd::SumOp>(init, summands);
+        break;
+      }
+      case WorkloadOp::Exchange: {
+        bool isWrite = rng() % 2 != 0;
+        Value *data = pick();
+        result = b.create<xd::ExchangeOp>(isWrite, data);
+        break;
+      }
+      case WorkloadOp::UMin: {
+        Value *lhs = pick();
+        Value *rhs = pick();
+        result = b.create<xd::UMinOp>(lhs, rhs);
+        break;
+      }
+      case WorkloadOp::Ctlz:
+        result = b.create<xd::CountLeadingZerosOp>(false, pick());
+        break;
+      }
+      if (result)
+        values.push_back(result);
+    }
+
+    b.CreateRet(values.back());
+  }
+
+  return numOps;
+}
+
+unsigned visitWorkload(Module &module, DialectContext &dialectContext,
+                       VisitorStrategy strategy) {
+  auto count = [](unsigned &numOps, auto &) { ++numOps; };
+  auto visitor = VisitorBuilder<unsigned>()
+                     .setStrategy(strategy)
+                     .add<xd::ReadOp>(count)
+                     .add<xd::WriteOp>(count)
+                     .add<xd::Add32Op>(count)
+                     .add<xd::CombineOp>(count)
+                     .add<xd::SumOp>(count)
+                     .add<xd::ExchangeOp>(count)
+                     .add<xd::UMinOp>(count)
+                     .add<xd::CountLeadingZerosOp>(count)
+                     .build();
+  unsigned numOps = 0;
+  visitor.visit(numOps, module, dialectContext);
+  return numOps;
+}
+
+/// Prints the JSON entry of a phase with its duration.
+class WorkloadPhase {
+public:
+  WorkloadPhase(raw_ostream &out, StringRef name, bool first = false)
+      : m_out(out), m_start(std::chrono::steady_clock::now()) {
+    m_out << (first ? "" : ",\n") << "    \"" << name << "\": {";
+  }
+
+  /// Stop the clock and print the duration, followed by @p key and @p value.
+  template <typename T> void finish(StringRef key, const T &value) {
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - m_start;
+    m_out << "\"ms\": " << format("%.3f", elapsed.count()) << ", \"" << key
+          << "\": " << value << "}";
+  }
+
+private:
+  raw_ostream &m_out;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+int runWorkload(DialectContext &dialectContext) {
+  SmallVector<std::pair<unsigned, WorkloadOp>> mix;
+  if (!parseWorkloadMix(g_workloadMix, mix))
+    return 1;
+
+  raw_ostream &out = outs();
+  out << "{\n  \"functions\": " << g_workloadFunctions
+      << ",\n  \"ops_per_function\": " << g_workloadOps
+      << ",\n  \"seed\": " << g_workloadSeed << ",\n  \"phases\": {\n";
+
+  Module module("workload", dialectContext.getContext());
+  {
+    WorkloadPhase phase(out, "build", true);
+    unsigned numOps = createWorkload(module, mix);
+    phase.finish("ops", numOps);
+  }
+  {
+    WorkloadPhase phase(out, "visit_by_instruction");
+    unsigned numOps =
+        visitWorkload(module, dialectContext, VisitorStrategy::ByInstruction);
+    phase.finish("ops", numOps);
+  }
+  {
+    WorkloadPhase phase(out, "visit_by_declaration");
+    unsigned numOps = visitWorkload(module, dialectContext,
+                                    VisitorStrategy::ByFunctionDeclaration);
+    phase.finish("ops", numOps);
+  }
+  {
+    WorkloadPhase phase(out, "lower");
+    unsigned numOps = lowerModuleExample(
+        module, g_lowerOutlined ? LoweringMode::Outline : LoweringMode::Inline);
+    phase.finish("ops", numOps);
+  }
+  bool broken;
+  {
+    WorkloadPhase phase(out, "verify");
+    broken = verifyModule(module, &errs());
+    phase.finish("ok", broken ? "false" : "true");
+  }
+
+  SmallVector<char, 0> bitcode;
+  {
+    WorkloadPhase phase(out, "bitcode_write");
+    raw_svector_ostream stream(bitcode);
+    WriteBitcodeToFile(module, stream);
+    phase.finish("bytes", bitcode.size());
+  }
+  dialectContext.invalidateDeclarationDirectory(module);
+  {
+    WorkloadPhase phase(out, "bitcode_read");
+    LLVMContext readContext;
+    Expected<std::unique_ptr<Module>> readModule = parseBitcodeFile(
+        MemoryBufferRef(StringRef(bitcode.data(), bitcode.size()), "workload"),
+        readContext);
+    if (!readModule) {
+      errs() << toString(readModule.takeError()) << '\n';
+      return 1;
+    }
+    phase.finish("instructions", (*readModule)->getInstructionCount());
+  }
+
+  out << "\n  }\n}\n";
+  return broken ? 1 : 0;
+}
+
+} // anonymous namespace
+
 int main(int argc, char **argv) {
+  cl::ParseCommandLineOptions(argc, argv);
+
   LLVMContext context;
   auto dialectContext = DialectContext::make<xd::ExampleDialect>(context);
+  if (g_declarationDirectory)
+    dialectContext->enableDeclarationDirectory();
+  dialectContext->setCompactOverloadNames(g_compactOverloadNames);
+
+  if (g_workload)
+    return runWorkload(*dialectContext);
 
   auto module = createModuleExample(context);
 
+  if (g_widenCombine)
+    widenCombineExample(*module);
+
+  if (g_intrinsicOps) {
+    createIntrinsicExample(*module);
+    visitIntrinsicExample(*module, *dialectContext);
+  }
+
+  if (g_compactOverloadNames) {
+    createCompactExample(*module);
+    visitCompactExample(*module, *dialectContext);
+  }
+
+  if (g_variadic) {
+    createVariadicExample(*module);
+    visitVariadicExample(*module, *dialectContext);
+  }
+
+  if (g_exchange)
+    createExchangeExample(*module);
+
+  if (g_declarationChurn)
+    declarationChurnExample(*module, *dialectContext);
+
+  if (g_inlinePureHelpers) {
+    createHelperExample(*module);
+    inlinePureDialectFunctions(*module, {"xd"});
+  }
+
+  if (g_dialectUsage) {
+    DialectUsageSchema schema;
+    schema.addDialect<xd::ExampleDialect>();
+    schema.addOps<xd::ReadOp, xd::WriteOp>();
+    schema.addOps<xd::Add32Op>();
+    schema.addDialect("unused");
+    computeDialectUsage(*module, schema);
+  }
+
+  if (g_instrumentOpCounts) {
+    const OpDescription *ops[] = {
+        &OpDescription::get<xd::ReadOp>(),
+        &OpDescription::get<xd::WriteOp>(),
+        &OpDescription::get<xd::Add32Op>(),
+        &OpDescription::get<xd::CombineOp>(),
+    };
+    instrumentOpCounts(*module, ops);
+
+    // Instrumenting again leaves the module unchanged.
+    [[maybe_unused]] bool changed = instrumentOpCounts(*module, ops);
+    assert(!changed);
+  }
+
+  if (g_lower || g_lowerOutlined) {
+    createMainExample(*module);
+    lowerModuleExample(*module, g_lowerOutlined ? LoweringMode::Outline
+                                                : LoweringMode::Inline);
+    if (verifyModule(*module, &errs()))
+      return 1;
+    visitLoweredExample(*module, *dialectContext);
+  }
+
   module->print(llvm::outs(), nullptr, false);
 
   return 0;
@@ -41,6 +41,7 @@ enum class Action {
   PrintRecords,
   GenDialectDecls,
   GenDialectDefs,
+  GenDialectBench,
 };
 
 cl::opt<Action> g_action(
@@ -50,7 +51,10 @@ cl::opt<Action> g_action(
         clEnumValN(Action::GenDialectDecls, "gen-dialect-decls",
                    "Generate dialect declarations (.h.inc)"),
         clEnumValN(Action::GenDialectDefs, "gen-dialect-defs",
-                   "Generate dialect definitions (.cpp.inc)")
+                   "Generate dialect definitions (.cpp.inc)"),
+        clEnumValN(Action::GenDialectBench, "gen-dialect-bench",
+                   "Generate a benchmark for the dialect's operations "
+                   "(.cpp.inc)")
         ));
 
 bool llvmDialectsTableGenMain(raw_ostream& out, RecordKeeper& records) {
@@ -65,6 +69,9 @@ bool llvmDialectsTableGenMain(raw_ostream& out, RecordKeeper& records) {
   case Action::GenDialectDefs:
     genDialectDefs(out, records);
     break;
+  case Action::GenDialectBench:
+    genDialectBench(out, records);
+    break;
   }
 
   return false;